@@ -2,22 +2,13 @@
 
 #include "ContentBrowserModule.h"
 #include "IContentBrowserSingleton.h"
+#include "UnrealToUnityExporterAssetSearch.h"
 #include "Algo/RemoveIf.h"
-#include "AssetRegistry/AssetRegistryModule.h"
-#include "AssetRegistry/IAssetRegistry.h"
 #include "Widgets/Input/SMultiLineEditableTextBox.h"
 #include "Widgets/Input/SNumericEntryBox.h"
 
 #define LOCTEXT_NAMESPACE "UnrealToUnityExporter"
 
-namespace
-{
-	const TArray<FTopLevelAssetPath> SupportedTypes =
-	{
-		FTopLevelAssetPath(TEXT("/Script/Engine.StaticMesh"))
-	};
-}
-
 void SExportSettingsWindow::Construct(const FArguments& InArgs)
 {
 	OnExportSettingsDone = InArgs._OnExportSettingsDone;
@@ -25,6 +16,16 @@ void SExportSettingsWindow::Construct(const FArguments& InArgs)
 	CurrentSelectedMode = AssetSelectionModes.Add_GetRef(MakeShared<FString>(AddSelectedAssetsMode));
 	AssetSelectionModes.Add(MakeShared<FString>(AddAssetsBySearchMode));
 	AssetSelectionModes.Add(MakeShared<FString>(AddAssetsBySearchAndExcludingMode));
+
+	for (const EExportPngCompression PngCompression : { EExportPngCompression::Default, EExportPngCompression::Fast, EExportPngCompression::Small })
+	{
+		PngCompressionNames.Add(MakeShared<FString>(LexToString(PngCompression)));
+	}
+
+	for (const EExportLodStrategy LodStrategy : { EExportLodStrategy::AllLods, EExportLodStrategy::Lod0Only, EExportLodStrategy::FirstOccurrence })
+	{
+		LodStrategyNames.Add(MakeShared<FString>(LexToString(LodStrategy)));
+	}
 	
 	SWindow::Construct(SWindow::FArguments()
 		.Title(LOCTEXT("WindowTitle", "Unreal to Unity Exporter Settings"))
@@ -79,6 +80,331 @@ void SExportSettingsWindow::Construct(const FArguments& InArgs)
 				]
 			]
 			+ SVerticalBox::Slot()
+			.Padding(8.f)
+			[
+				SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.VAlign(VAlign_Center)
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("ResumeExportLabel", "Resume Interrupted Export"))
+				]
+				+ SHorizontalBox::Slot()
+				[
+					SNew(SCheckBox)
+					.IsChecked_Lambda([this]
+					{
+						return ExportSettings.bResumeExport ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+					})
+					.OnCheckStateChanged_Lambda([this] (ECheckBoxState CheckBoxState)
+					{
+						ExportSettings.bResumeExport = CheckBoxState == ECheckBoxState::Checked;
+					})
+				]
+			]
+			+ SVerticalBox::Slot()
+			.Padding(8.f)
+			[
+				SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.VAlign(VAlign_Center)
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("BinaryImportDescriptorLabel", "Binary Import Descriptor"))
+				]
+				+ SHorizontalBox::Slot()
+				[
+					SNew(SCheckBox)
+					.IsChecked_Lambda([this]
+					{
+						return ExportSettings.bBinaryImportDescriptor ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+					})
+					.OnCheckStateChanged_Lambda([this] (ECheckBoxState CheckBoxState)
+					{
+						ExportSettings.bBinaryImportDescriptor = CheckBoxState == ECheckBoxState::Checked;
+					})
+				]
+			]
+			+ SVerticalBox::Slot()
+			.Padding(8.f)
+			[
+				SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.VAlign(VAlign_Center)
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("UniformTexturesAsConstantsLabel", "Flat Textures As Constants"))
+				]
+				+ SHorizontalBox::Slot()
+				[
+					SNew(SCheckBox)
+					.IsChecked_Lambda([this]
+					{
+						return ExportSettings.bUniformTexturesAsConstants ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+					})
+					.OnCheckStateChanged_Lambda([this] (ECheckBoxState CheckBoxState)
+					{
+						ExportSettings.bUniformTexturesAsConstants = CheckBoxState == ECheckBoxState::Checked;
+					})
+				]
+			]
+			+ SVerticalBox::Slot()
+			.Padding(8.f)
+			[
+				SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.VAlign(VAlign_Center)
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("CompressedTexturesLabel", "Compressed DDS Textures"))
+				]
+				+ SHorizontalBox::Slot()
+				[
+					SNew(SCheckBox)
+					.IsChecked_Lambda([this]
+					{
+						return ExportSettings.bCompressedTextures ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+					})
+					.OnCheckStateChanged_Lambda([this] (ECheckBoxState CheckBoxState)
+					{
+						ExportSettings.bCompressedTextures = CheckBoxState == ECheckBoxState::Checked;
+					})
+				]
+			]
+			+ SVerticalBox::Slot()
+			.Padding(8.f)
+			[
+				SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.VAlign(VAlign_Center)
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("PackMaskMapsLabel", "Pack Mask Maps"))
+				]
+				+ SHorizontalBox::Slot()
+				[
+					SNew(SCheckBox)
+					.IsChecked_Lambda([this]
+					{
+						return ExportSettings.bPackMaskMaps ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+					})
+					.OnCheckStateChanged_Lambda([this] (ECheckBoxState CheckBoxState)
+					{
+						ExportSettings.bPackMaskMaps = CheckBoxState == ECheckBoxState::Checked;
+					})
+				]
+			]
+			+ SVerticalBox::Slot()
+			.Padding(8.f)
+			[
+				SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.VAlign(VAlign_Center)
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("PassThroughMaterialsLabel", "Export Simple Materials Without Baking"))
+				]
+				+ SHorizontalBox::Slot()
+				[
+					SNew(SCheckBox)
+					.IsChecked_Lambda([this]
+					{
+						return ExportSettings.bPassThroughMaterials ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+					})
+					.OnCheckStateChanged_Lambda([this] (ECheckBoxState CheckBoxState)
+					{
+						ExportSettings.bPassThroughMaterials = CheckBoxState == ECheckBoxState::Checked;
+					})
+				]
+			]
+			+ SVerticalBox::Slot()
+			.Padding(8.f)
+			[
+				SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.VAlign(VAlign_Center)
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("MergeEquivalentMaterialsLabel", "Merge Equivalent Material Instances"))
+				]
+				+ SHorizontalBox::Slot()
+				[
+					SNew(SCheckBox)
+					.IsChecked_Lambda([this]
+					{
+						return ExportSettings.bMergeEquivalentMaterials ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+					})
+					.OnCheckStateChanged_Lambda([this] (ECheckBoxState CheckBoxState)
+					{
+						ExportSettings.bMergeEquivalentMaterials = CheckBoxState == ECheckBoxState::Checked;
+					})
+				]
+			]
+			+ SVerticalBox::Slot()
+			.Padding(8.f)
+			[
+				SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.VAlign(VAlign_Center)
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("PngCompressionLabel", "PNG Compression"))
+				]
+				+ SHorizontalBox::Slot()
+				[
+					SNew(SComboBox<TSharedPtr<FString>>)
+					.OptionsSource(&PngCompressionNames)
+					.OnGenerateWidget_Lambda([] (const TSharedPtr<FString>& Item)
+					{
+						return SNew(STextBlock)
+						.Text(FText::FromString(*Item));
+					})
+					.OnSelectionChanged_Lambda([this] (const TSharedPtr<FString>& Item, ESelectInfo::Type SelectInfo)
+					{
+						if (Item)
+						{
+							LexFromString(ExportSettings.PngCompression, **Item);
+						}
+					})
+					[
+						SNew(STextBlock)
+						.Text_Lambda([this]
+						{
+							return FText::FromString(LexToString(ExportSettings.PngCompression));
+						})
+					]
+				]
+			]
+			+ SVerticalBox::Slot()
+			.Padding(8.f)
+			[
+				SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.VAlign(VAlign_Center)
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("LodStrategyLabel", "LOD Strategy"))
+				]
+				+ SHorizontalBox::Slot()
+				[
+					SNew(SComboBox<TSharedPtr<FString>>)
+					.OptionsSource(&LodStrategyNames)
+					.OnGenerateWidget_Lambda([] (const TSharedPtr<FString>& Item)
+					{
+						return SNew(STextBlock)
+						.Text(FText::FromString(*Item));
+					})
+					.OnSelectionChanged_Lambda([this] (const TSharedPtr<FString>& Item, ESelectInfo::Type SelectInfo)
+					{
+						if (Item)
+						{
+							LexFromString(ExportSettings.LodStrategy, **Item);
+						}
+					})
+					[
+						SNew(STextBlock)
+						.Text_Lambda([this]
+						{
+							return FText::FromString(LexToString(ExportSettings.LodStrategy));
+						})
+					]
+				]
+			]
+			+ SVerticalBox::Slot()
+			.Padding(8.f)
+			[
+				SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.VAlign(VAlign_Center)
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("TextureWriterThreadsLabel", "Texture Writer Threads (0 = All Workers)"))
+				]
+				+ SHorizontalBox::Slot()
+				[
+					SNew(SNumericEntryBox<int32>)
+					.MinValue(0)
+					.Value_Lambda([this]
+					{
+						return ExportSettings.TextureWriterThreads;
+					})
+					.OnValueCommitted_Lambda([this] (int32 NewValue, ETextCommit::Type)
+					{
+						ExportSettings.TextureWriterThreads = NewValue;
+					})
+				]
+			]
+			+ SVerticalBox::Slot()
+			.Padding(8.f)
+			[
+				SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.VAlign(VAlign_Center)
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("MeshExportProcessesLabel", "FBX Export Processes (0 = In Editor)"))
+				]
+				+ SHorizontalBox::Slot()
+				[
+					SNew(SNumericEntryBox<int32>)
+					.MinValue(0)
+					.Value_Lambda([this]
+					{
+						return ExportSettings.MeshExportProcesses;
+					})
+					.OnValueCommitted_Lambda([this] (int32 NewValue, ETextCommit::Type)
+					{
+						ExportSettings.MeshExportProcesses = NewValue;
+					})
+				]
+			]
+			+ SVerticalBox::Slot()
+			.Padding(8.f)
+			[
+				SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.VAlign(VAlign_Center)
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("UseExportCacheLabel", "Skip Unchanged Meshes"))
+				]
+				+ SHorizontalBox::Slot()
+				[
+					SNew(SCheckBox)
+					.IsChecked_Lambda([this]
+					{
+						return ExportSettings.bUseExportCache ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+					})
+					.OnCheckStateChanged_Lambda([this] (ECheckBoxState CheckBoxState)
+					{
+						ExportSettings.bUseExportCache = CheckBoxState == ECheckBoxState::Checked;
+					})
+				]
+			]
+			+ SVerticalBox::Slot()
+			.Padding(8.f)
+			[
+				SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.VAlign(VAlign_Center)
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("UseBakeCacheLabel", "Reuse Baked Materials From Derived Data Cache"))
+				]
+				+ SHorizontalBox::Slot()
+				[
+					SNew(SCheckBox)
+					.IsChecked_Lambda([this]
+					{
+						return ExportSettings.bUseBakeCache ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+					})
+					.OnCheckStateChanged_Lambda([this] (ECheckBoxState CheckBoxState)
+					{
+						ExportSettings.bUseBakeCache = CheckBoxState == ECheckBoxState::Checked;
+					})
+				]
+			]
+			+ SVerticalBox::Slot()
 			.AutoHeight()
 			.Padding(8.f)
 			[
@@ -169,11 +495,18 @@ TSharedRef<SWidget> SExportSettingsWindow::CreateAssetSelectorWidget()
 		.Text(LOCTEXT("RemoveSelectedAssets", "-"))
 		.OnClicked_Lambda([this]
 		{
-			const TArray<TSharedPtr<FAssetData>> ItemsToRemove = SelectedAssetsListView->GetSelectedItems();
+			const TSet<TSharedPtr<FAssetData>> ItemsToRemove(SelectedAssetsListView->GetSelectedItems());
 			ExportSettings.SelectedAssets.SetNum(Algo::RemoveIf(ExportSettings.SelectedAssets, [this, &ItemsToRemove] (const TSharedPtr<FAssetData>& Item)
 			{
-				return ItemsToRemove.Contains(Item);
+				if (ItemsToRemove.Contains(Item))
+				{
+					SelectedAssetPaths.Remove(Item->ToSoftObjectPath());
+					return true;
+				}
+
+				return false;
 			}));
+			SelectedAssetsListView->RequestListRefresh();
 			return FReply::Handled();
 		})
 	]
@@ -212,7 +545,7 @@ TSharedRef<ITableRow> SExportSettingsWindow::GenerateSelectedAssetsList(TSharedP
 	return SNew(STableRow<TSharedPtr<FAssetData>>, TableViewBase)
 	[
 		SNew(STextBlock)
-		.Text(FText::FromString(AssetData->GetAsset()->GetPackage()->GetName()))
+		.Text(FText::FromName(AssetData->PackageName))
 	];
 }
 
@@ -292,36 +625,11 @@ TSharedRef<SWidget> SExportSettingsWindow::AddAssetsBySearchModeWidget()
 				TArray<FString> ObjectPathStrings;
 				AssetSearchEditableText->GetText().ToString().ParseIntoArrayLines(ObjectPathStrings);
 				
-				FARFilter Filter;
-				Filter.bIncludeOnlyOnDiskAssets = true;
-				Filter.ClassPaths = SupportedTypes;
-				
-				Algo::Transform(ObjectPathStrings, Filter.SoftObjectPaths, [] (const FString& ObjectPathString)
-				{
-					return FSoftObjectPath(ObjectPathString);
-				});
-
-				const IAssetRegistry& AssetRegistry = FModuleManager::Get().LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
 				TArray<FAssetData> Assets;
+				ErrorCount += FUnrealToUnityExporterAssetSearch::FindAssetsByObjectPaths(ObjectPathStrings, Assets);
 				
-				if (AssetRegistry.GetAssets(Filter, Assets))
-				{
-					for (const FSoftObjectPath& ObjectPath : Filter.SoftObjectPaths)
-					{
-						const bool bIsFound = Assets.ContainsByPredicate([&ObjectPath] (const FAssetData& AssetData)
-						{
-							return AssetData.ToSoftObjectPath() == ObjectPath;
-						});
-						
-						if (!bIsFound)
-						{
-							ErrorCount++;
-						}
-					}
-					
-					AddAssetsToSelectedAssetsUnique(Assets);
-					SelectedAssetsListView->RebuildList();
-				}
+				AddAssetsToSelectedAssetsUnique(Assets);
+				SelectedAssetsListView->RebuildList();
 				
 				return FReply::Handled();
 			})
@@ -376,65 +684,11 @@ TSharedRef<SWidget> SExportSettingsWindow::AddAssetsBySearchAndExcludingModeWidg
 				TArray<FString> ExcludeAssetPaths;
 				ExcludeAssetPathsEditableTextBox->GetText().ToString().ParseIntoArrayLines(ExcludeAssetPaths);
 				
-				FARFilter Filter;
-				Filter.bIncludeOnlyOnDiskAssets = true;
-				Filter.bRecursivePaths = true;
-				Filter.ClassPaths = SupportedTypes;
-				
-				Algo::Transform(FolderPaths, Filter.PackagePaths, [] (const FString& FolderPath)
-				{
-					return FName(FolderPath);
-				});
-
-				const IAssetRegistry& AssetRegistry = FModuleManager::Get().LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
 				TArray<FAssetData> Assets;
-
-				TArray<FAssetData> ExcludeAssets;
-				FARFilter ExcludeAssetsFilter;
-				ExcludeAssetsFilter.bIncludeOnlyOnDiskAssets = true;
+				ErrorCount += FUnrealToUnityExporterAssetSearch::FindAssetsInFolders(FolderPaths, ExcludeStrings, ExcludeAssetPaths, Assets);
 				
-				Algo::Transform(ExcludeAssetPaths, ExcludeAssetsFilter.SoftObjectPaths, [] (const FString& AssetPath)
-				{
-					return FSoftObjectPath(AssetPath);
-				});
-
-				AssetRegistry.GetAssets(ExcludeAssetsFilter, ExcludeAssets);
-
-				ErrorCount += ExcludeAssetPaths.Num() - ExcludeAssets.Num();
-				
-				if (AssetRegistry.GetAssets(Filter, Assets))
-				{
-					Assets.SetNum(Algo::RemoveIf(Assets, [this, &ExcludeAssets] (const FAssetData& AssetData)
-					{
-						const int32 Index = ExcludeAssets.IndexOfByKey(AssetData);
-						
-						if (Index != INDEX_NONE)
-						{
-							ExcludeAssets.RemoveAt(Index);
-							return true;
-						}
-						
-						return false;
-					}));
-
-					ErrorCount += ExcludeAssets.Num();
-
-					Assets.SetNum(Algo::RemoveIf(Assets, [&ExcludeStrings] (const FAssetData& AssetData)
-					{
-						for (const FString& ExcludeString : ExcludeStrings)
-						{
-							if (AssetData.AssetName.ToString().Contains(ExcludeString))
-							{
-								return true;
-							}
-						}
-
-						return false;
-					}));
-					
-					AddAssetsToSelectedAssetsUnique(Assets);
-					SelectedAssetsListView->RebuildList();
-				}
+				AddAssetsToSelectedAssetsUnique(Assets);
+				SelectedAssetsListView->RebuildList();
 				
 				return FReply::Handled();
 			})
@@ -443,16 +697,20 @@ TSharedRef<SWidget> SExportSettingsWindow::AddAssetsBySearchAndExcludingModeWidg
 
 void SExportSettingsWindow::AddAssetsToSelectedAssetsUnique(const TArray<FAssetData>& Assets)
 {
-	Algo::TransformIf(Assets, ExportSettings.SelectedAssets, [this] (const FAssetData& AssetData)
+	// Registry data is enough to list the assets, nothing is loaded until the export starts
+	SelectedAssetPaths.Reserve(SelectedAssetPaths.Num() + Assets.Num());
+	ExportSettings.SelectedAssets.Reserve(ExportSettings.SelectedAssets.Num() + Assets.Num());
+
+	for (const FAssetData& AssetData : Assets)
 	{
-		return !ExportSettings.SelectedAssets.ContainsByPredicate([&AssetData] (const TSharedPtr<FAssetData>& SelectedAsset)
+		bool bIsAlreadySelected = false;
+		SelectedAssetPaths.Add(AssetData.ToSoftObjectPath(), &bIsAlreadySelected);
+
+		if (!bIsAlreadySelected)
 		{
-			return *SelectedAsset == AssetData;
-		});
-	},[] (const FAssetData& AssetData)
-	{
-		return MakeShared<FAssetData>(AssetData);
-	});
+			ExportSettings.SelectedAssets.Add(MakeShared<FAssetData>(AssetData));
+		}
+	}
 }
 
 #undef LOCTEXT_NAMESPACE
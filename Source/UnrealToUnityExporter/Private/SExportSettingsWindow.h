@@ -2,10 +2,93 @@
 
 #include "Widgets/SWindow.h"
 
+/** Zlib effort for exported PNGs, Fast trades somewhat bigger files for much quicker encoding on iteration exports */
+enum class EExportPngCompression : uint8
+{
+	Default,
+	Fast,
+	Small,
+};
+
+inline const TCHAR* LexToString(EExportPngCompression PngCompression)
+{
+	switch (PngCompression)
+	{
+	case EExportPngCompression::Fast: return TEXT("Fast");
+	case EExportPngCompression::Small: return TEXT("Small");
+	default: return TEXT("Default");
+	}
+}
+
+inline void LexFromString(EExportPngCompression& OutPngCompression, const TCHAR* String)
+{
+	OutPngCompression = FCString::Stricmp(String, TEXT("Fast")) == 0 ? EExportPngCompression::Fast
+		: FCString::Stricmp(String, TEXT("Small")) == 0 ? EExportPngCompression::Small
+		: EExportPngCompression::Default;
+}
+
+/** Which LODs contribute material slots, every slot is baked once no matter how many LODs use it */
+enum class EExportLodStrategy : uint8
+{
+	/** Slots of every LOD, each baked at the LOD where it covers the most triangles */
+	AllLods,
+	/** Only LOD0 is exported and baked */
+	Lod0Only,
+	/** Slots of every LOD, each baked at the first LOD using it */
+	FirstOccurrence,
+};
+
+inline const TCHAR* LexToString(EExportLodStrategy LodStrategy)
+{
+	switch (LodStrategy)
+	{
+	case EExportLodStrategy::Lod0Only: return TEXT("Lod0Only");
+	case EExportLodStrategy::FirstOccurrence: return TEXT("FirstOccurrence");
+	default: return TEXT("AllLods");
+	}
+}
+
+inline void LexFromString(EExportLodStrategy& OutLodStrategy, const TCHAR* String)
+{
+	OutLodStrategy = FCString::Stricmp(String, TEXT("Lod0Only")) == 0 ? EExportLodStrategy::Lod0Only
+		: FCString::Stricmp(String, TEXT("FirstOccurrence")) == 0 ? EExportLodStrategy::FirstOccurrence
+		: EExportLodStrategy::AllLods;
+}
+
 struct FExportSettings
 {
 	int32 TextureSize = 2048;
 	bool bEnableReadWrite = false;
+	bool bUseExportCache = true;
+	/** Baked material pixels are shared through the derived data cache, across sessions and machines */
+	bool bUseBakeCache = true;
+	int32 TextureWriterThreads = 0;
+	int32 TextureWriterQueueSize = 16;
+	/** Separate editor processes writing FBX files, 0 or 1 exports them in this process */
+	int32 MeshExportProcesses = 0;
+	bool bResumeExport = false;
+	int32 MeshesPerBatch = 64;
+	/** Materials rendered by one material baking call, their baked pixels are all in memory at the same time */
+	int32 MaterialsPerBake = 8;
+	bool bNotifyUnity = true;
+	bool bBinaryImportDescriptor = false;
+	bool bUniformTexturesAsConstants = true;
+	/** Largest difference within a channel, in 8 bit steps, for an image to still count as uniform */
+	int32 UniformTextureTolerance = 2;
+	/** Writes block compressed DDS files with mips instead of PNG */
+	bool bCompressedTextures = false;
+	/** BC1/BC3 instead of BC7 for color textures when compressing */
+	bool bFastBlockCompression = false;
+	EExportPngCompression PngCompression = EExportPngCompression::Default;
+	/** Metallic and roughness go into a single Unity mask map instead of one texture each */
+	bool bPackMaskMaps = false;
+	/** Materials only forwarding texture and constant parameters skip the bake, their source textures are exported */
+	bool bPassThroughMaterials = true;
+	/** Material instances with the same base material and effective parameter values share one baked Unity material */
+	bool bMergeEquivalentMaterials = true;
+	EExportLodStrategy LodStrategy = EExportLodStrategy::AllLods;
+	/** Absolute or project relative, the project's Saved/UnrealToUnityExporter folder when empty */
+	FString ExportDirectory;
 	TArray<TSharedPtr<FAssetData>> SelectedAssets;
 };
 
@@ -46,8 +129,12 @@ private:
 	static inline const FString AddAssetsBySearchMode = TEXT("Add Assets by Search");
 	static inline const FString AddAssetsBySearchAndExcludingMode = TEXT("Add Assets by Search and Excluding");
 	TArray<TSharedPtr<FString>> AssetSelectionModes;
+	TArray<TSharedPtr<FString>> PngCompressionNames;
+	TArray<TSharedPtr<FString>> LodStrategyNames;
 	TSharedPtr<FString> CurrentSelectedMode;
 	TSharedPtr<SVerticalBox> ModeWidgetContainer;
 	TSharedPtr<SListView<TSharedPtr<FAssetData>>> SelectedAssetsListView;
+	/** Mirrors ExportSettings.SelectedAssets so adding whole folders doesn't compare against every selected asset */
+	TSet<FSoftObjectPath> SelectedAssetPaths;
 	int32 ErrorCount = 0;
 };
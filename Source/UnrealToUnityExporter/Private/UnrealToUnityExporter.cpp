@@ -2,25 +2,658 @@
 
 #include "UnrealToUnityExporter.h"
 
-#include "AssetToolsModule.h"
+#include "AssetExportTask.h"
 #include "IContentBrowserSingleton.h"
+#include "IMaterialBakingModule.h"
+#include "ImageCore.h"
 #include "ImageUtils.h"
-#include "IMeshMergeUtilities.h"
-#include "JsonObjectConverter.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialExpressionConstant.h"
+#include "Materials/MaterialExpressionConstant3Vector.h"
+#include "Materials/MaterialExpressionConstant4Vector.h"
+#include "Materials/MaterialExpressionScalarParameter.h"
+#include "Materials/MaterialExpressionTextureSampleParameter2D.h"
+#include "Materials/MaterialExpressionVectorParameter.h"
+#include "Materials/MaterialInstanceConstant.h"
+#include "MaterialBakingStructures.h"
 #include "MaterialOptions.h"
-#include "MeshMergeModule.h"
-#include "PackageTools.h"
-#include "ScopedTransaction.h"
+#include "MaterialUtilities.h"
 #include "SExportSettingsWindow.h"
-#include "Sockets.h"
+#include "StaticMeshResources.h"
 #include "ToolMenus.h"
+#include "UnrealToUnityExporterAssetLoader.h"
+#include "UnrealToUnityExporterBakeCache.h"
+#include "UnrealToUnityExporterDescriptorWriter.h"
+#include "UnrealToUnityExporterExportCache.h"
+#include "UnrealToUnityExporterExportJournal.h"
+#include "UnrealToUnityExporterExportReport.h"
+#include "UnrealToUnityExporterFbxWorkers.h"
+#include "UnrealToUnityExporterImportNotifier.h"
 #include "UnrealToUnityExporterStaticMeshAdapter.h"
-#include "Common/TcpSocketBuilder.h"
+#include "UnrealToUnityExporterTextureWriter.h"
+#include "Engine/Font.h"
+#include "Exporters/Exporter.h"
+#include "Exporters/FbxExportOption.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/ScopedTimers.h"
+#include "UObject/UObjectHash.h"
+#include "VT/RuntimeVirtualTexture.h"
 
 #define LOCTEXT_NAMESPACE "FUnrealToUnityExporterModule"
 
+namespace
+{
+	FString GetBakedMaterialName(FName OriginalMaterialName)
+	{
+		const FString OriginalMaterialPathStr = OriginalMaterialName.ToString();
+		return FString::Printf(TEXT("%s_%s"), *FPaths::GetCleanFilename(OriginalMaterialPathStr), *FMD5::HashAnsiString(*OriginalMaterialPathStr));
+	}
+
+	bool AreMaterialFilesWritten(const FUnrealToUnityExporterMaterialDescriptor& MaterialDescriptor, const FUnrealToUnityExporterTextureWriter& TextureWriter)
+	{
+		if (!MaterialDescriptor.MaskMapPath.IsEmpty() && TextureWriter.IsWriteFailed(MaterialDescriptor.MaskMapPath))
+		{
+			return false;
+		}
+
+		return !MaterialDescriptor.TextureDescriptors.ContainsByPredicate([&TextureWriter] (const FUnrealToUnityExporterTextureDescriptor& TextureDescriptor)
+		{
+			return !TextureDescriptor.TexturePath.IsEmpty() && TextureWriter.IsWriteFailed(TextureDescriptor.TexturePath);
+		});
+	}
+
+	bool AppendParameterValue(const FMaterialParameterValue& Value, FString& OutKeyString)
+	{
+		switch (Value.Type)
+		{
+		case EMaterialParameterType::Scalar:
+			OutKeyString += FString::Printf(TEXT("%.9g"), Value.Float[0]);
+			return true;
+		case EMaterialParameterType::Vector:
+			OutKeyString += FString::Printf(TEXT("%.9g,%.9g,%.9g,%.9g"), Value.Float[0], Value.Float[1], Value.Float[2], Value.Float[3]);
+			return true;
+		case EMaterialParameterType::DoubleVector:
+			OutKeyString += FString::Printf(TEXT("%.17g,%.17g,%.17g,%.17g"), Value.Double[0], Value.Double[1], Value.Double[2], Value.Double[3]);
+			return true;
+		case EMaterialParameterType::Texture:
+			OutKeyString += GetPathNameSafe(Value.Texture);
+			return true;
+		case EMaterialParameterType::Font:
+			OutKeyString += FString::Printf(TEXT("%s,%d"), *GetPathNameSafe(Value.Font), Value.FontPage);
+			return true;
+		case EMaterialParameterType::RuntimeVirtualTexture:
+			OutKeyString += GetPathNameSafe(Value.RuntimeVirtualTexture);
+			return true;
+		case EMaterialParameterType::StaticSwitch:
+			OutKeyString += Value.Bool[0] ? TEXT("1") : TEXT("0");
+			return true;
+		case EMaterialParameterType::StaticComponentMask:
+			OutKeyString += FString::Printf(TEXT("%d%d%d%d"), Value.Bool[0], Value.Bool[1], Value.Bool[2], Value.Bool[3]);
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	/**
+	 * Materials with the same base material, overrides and effective parameter values render the same, no matter which instances
+	 * they inherit them from. Anything which can't be compared makes the material its own key.
+	 */
+	FString GetCanonicalMaterialKey(UMaterialInterface& MaterialInterface)
+	{
+		const UMaterial* Material = MaterialInterface.GetMaterial();
+
+		if (!Material)
+		{
+			return MaterialInterface.GetPathName();
+		}
+
+		FString KeyString = FString::Printf(TEXT("%s;Blend=%d;TwoSided=%d;Clip=%.9g;ShadingModels=%d"), *Material->GetPathName(), static_cast<int32>(MaterialInterface.GetBlendMode()),
+			MaterialInterface.IsTwoSided(), MaterialInterface.GetOpacityMaskClipValue(), MaterialInterface.GetShadingModels().GetShadingModelField());
+
+		for (int32 TypeIndex = 0; TypeIndex < NumMaterialParameterTypes; TypeIndex++)
+		{
+			TMap<FMaterialParameterInfo, FMaterialParameterMetadata> Parameters;
+			MaterialInterface.GetAllParametersOfType(static_cast<EMaterialParameterType>(TypeIndex), Parameters);
+
+			TArray<FString> ParameterStrings;
+
+			for (const auto& [ParameterInfo, ParameterMetadata] : Parameters)
+			{
+				FString ParameterString = FString::Printf(TEXT("%s,%d,%d="), *ParameterInfo.Name.ToString(), static_cast<int32>(ParameterInfo.Association), ParameterInfo.Index);
+
+				if (!AppendParameterValue(ParameterMetadata.Value, ParameterString))
+				{
+					return MaterialInterface.GetPathName();
+				}
+
+				ParameterStrings.Add(MoveTemp(ParameterString));
+			}
+
+			// Map order depends on how the parameters were collected
+			ParameterStrings.Sort();
+			KeyString += TEXT(";") + FString::Join(ParameterStrings, TEXT(";"));
+		}
+
+		return FMD5::HashAnsiString(*KeyString);
+	}
+
+	/** Inactive properties aren't rendered at all and unconnected ones bake to the same constants the proxy material defaults to */
+	bool IsPropertyUsed(UMaterialInterface& MaterialInterface, EMaterialProperty Property)
+	{
+		if (!MaterialInterface.IsPropertyActive(Property))
+		{
+			return false;
+		}
+
+		UMaterial* Material = MaterialInterface.GetMaterial();
+
+		// Inputs of material attributes can't be told apart
+		if (!Material || Material->bUseMaterialAttributes)
+		{
+			return true;
+		}
+
+		const FExpressionInput* ExpressionInput = Material->GetExpressionInputForProperty(Property);
+		return !ExpressionInput || ExpressionInput->IsConnected();
+	}
+
+	/** Zlib level for the engine's PNG encoder, 1 would mean uncompressed to it */
+	int32 GetPngQuality(EExportPngCompression PngCompression)
+	{
+		switch (PngCompression)
+		{
+		case EExportPngCompression::Fast: return 2;
+		case EExportPngCompression::Small: return 9;
+		default: return 0;
+		}
+	}
+
+	/** Normals keep their two significant channels, scalar properties a single one */
+	EUnrealToUnityExporterTextureFormat GetTextureFormat(const FString& ParameterName, const FImage& Image, const FExportSettings& ExportSettings)
+	{
+		if (!ExportSettings.bCompressedTextures)
+		{
+			return EUnrealToUnityExporterTextureFormat::PNG;
+		}
+
+		if (ParameterName == TEXT("Normal"))
+		{
+			return EUnrealToUnityExporterTextureFormat::BC5;
+		}
+
+		static const TSet<FString> ScalarParameterNames = { TEXT("Metallic"), TEXT("Specular"), TEXT("Roughness"), TEXT("Opacity"), TEXT("OpacityMask"), TEXT("AmbientOcclusion") };
+
+		if (ScalarParameterNames.Contains(ParameterName))
+		{
+			return EUnrealToUnityExporterTextureFormat::BC4;
+		}
+
+		if (!ExportSettings.bFastBlockCompression)
+		{
+			return EUnrealToUnityExporterTextureFormat::BC7;
+		}
+
+		FLinearColor MinColor;
+		FLinearColor MaxColor;
+		FImageCore::ComputeChannelLinearMinMax(Image, MinColor, MaxColor);
+		return MinColor.A < 1.f ? EUnrealToUnityExporterTextureFormat::BC3 : EUnrealToUnityExporterTextureFormat::BC1;
+	}
+
+	bool IsMaskMapProperty(const FString& ParameterName)
+	{
+		return ParameterName == TEXT("Metallic") || ParameterName == TEXT("Roughness");
+	}
+
+	/** Constant of a property which wasn't baked into a texture, DefaultValue if the material doesn't have one */
+	float GetConstantScalar(const TArray<FUnrealToUnityExporterTextureDescriptor>& TextureDescriptors, const FString& ParameterName, float DefaultValue)
+	{
+		for (const FUnrealToUnityExporterTextureDescriptor& TextureDescriptor : TextureDescriptors)
+		{
+			if (TextureDescriptor.ParameterName == ParameterName)
+			{
+				return TextureDescriptor.bUseScalar ? TextureDescriptor.Scalar : TextureDescriptor.bUseColor ? TextureDescriptor.Color.R : DefaultValue;
+			}
+		}
+
+		return DefaultValue;
+	}
+
+	/** First channel of the image as stored, scaled to the given size if needed */
+	TArray64<uint8> GetChannelValues(const FImage& Image, int32 SizeX, int32 SizeY)
+	{
+		FImage ConvertedImage;
+		Image.CopyTo(ConvertedImage, ERawImageFormat::BGRA8, Image.GammaSpace);
+
+		if (ConvertedImage.SizeX != SizeX || ConvertedImage.SizeY != SizeY)
+		{
+			FImage ResizedImage;
+			ConvertedImage.ResizeTo(ResizedImage, SizeX, SizeY, ERawImageFormat::BGRA8, ConvertedImage.GammaSpace);
+			ConvertedImage = MoveTemp(ResizedImage);
+		}
+
+		TArray64<uint8> Values;
+		Values.Reserve(ConvertedImage.GetNumPixels());
+
+		for (const FColor& Color : ConvertedImage.AsBGRA8())
+		{
+			Values.Add(Color.R);
+		}
+
+		return Values;
+	}
+
+	/** Properties without an image are filled with their constant, roughness is inverted into smoothness */
+	FImage CreateMaskMap(const TMap<FString, FImage>& MaskMapImages, const TArray<FUnrealToUnityExporterTextureDescriptor>& TextureDescriptors)
+	{
+		int32 SizeX = 1;
+		int32 SizeY = 1;
+
+		for (const TPair<FString, FImage>& MaskMapImage : MaskMapImages)
+		{
+			SizeX = FMath::Max(SizeX, MaskMapImage.Value.SizeX);
+			SizeY = FMath::Max(SizeY, MaskMapImage.Value.SizeY);
+		}
+
+		FImage MaskMap(SizeX, SizeY, ERawImageFormat::BGRA8, EGammaSpace::Linear);
+		const TArrayView64<FColor> MaskColors = MaskMap.AsBGRA8();
+
+		const uint8 Metallic = FMath::RoundToInt(FMath::Clamp(GetConstantScalar(TextureDescriptors, TEXT("Metallic"), 0.f), 0.f, 1.f) * 255.f);
+		const uint8 Smoothness = 255 - FMath::RoundToInt(FMath::Clamp(GetConstantScalar(TextureDescriptors, TEXT("Roughness"), 0.5f), 0.f, 1.f) * 255.f);
+
+		for (FColor& MaskColor : MaskColors)
+		{
+			MaskColor = FColor(Metallic, 255, 255, Smoothness);
+		}
+
+		if (const FImage* MetallicImage = MaskMapImages.Find(TEXT("Metallic")))
+		{
+			const TArray64<uint8> Values = GetChannelValues(*MetallicImage, SizeX, SizeY);
+			for (int64 PixelIndex = 0; PixelIndex < Values.Num(); PixelIndex++)
+			{
+				MaskColors[PixelIndex].R = Values[PixelIndex];
+			}
+		}
+
+		if (const FImage* RoughnessImage = MaskMapImages.Find(TEXT("Roughness")))
+		{
+			const TArray64<uint8> Values = GetChannelValues(*RoughnessImage, SizeX, SizeY);
+			for (int64 PixelIndex = 0; PixelIndex < Values.Num(); PixelIndex++)
+			{
+				MaskColors[PixelIndex].A = 255 - Values[PixelIndex];
+			}
+		}
+
+		return MaskMap;
+	}
+
+	/** Tolerance is the largest allowed difference between the lowest and highest value of a channel, in 8 bit steps */
+	bool IsImageUniform(const FImage& Image, int32 Tolerance, FLinearColor& OutColor)
+	{
+		if (Image.RawData.IsEmpty())
+		{
+			return false;
+		}
+
+		if (Image.Format != ERawImageFormat::BGRA8)
+		{
+			FLinearColor MinColor;
+			FLinearColor MaxColor;
+			FImageCore::ComputeChannelLinearMinMax(Image, MinColor, MaxColor);
+
+			const FLinearColor Range = MaxColor - MinColor;
+			OutColor = (MinColor + MaxColor) * 0.5f;
+			return FMath::Max(FMath::Max(Range.R, Range.G), FMath::Max(Range.B, Range.A)) * 255.f <= Tolerance;
+		}
+
+		// Byte wise min/max over 16 byte blocks, compilers turn the inner loops into packed min/max instructions
+		constexpr int32 BlockSize = 16;
+		const uint8* Data = Image.RawData.GetData();
+		const int64 Size = Image.RawData.Num();
+		const int64 BlockedSize = Size - Size % BlockSize;
+
+		uint8 BlockMin[BlockSize];
+		uint8 BlockMax[BlockSize];
+
+		for (int32 ByteIndex = 0; ByteIndex < BlockSize; ByteIndex++)
+		{
+			BlockMin[ByteIndex] = BlockMax[ByteIndex] = Data[ByteIndex % 4];
+		}
+
+		for (int64 Offset = 0; Offset < BlockedSize; Offset += BlockSize)
+		{
+			for (int32 ByteIndex = 0; ByteIndex < BlockSize; ByteIndex++)
+			{
+				BlockMin[ByteIndex] = FMath::Min(BlockMin[ByteIndex], Data[Offset + ByteIndex]);
+				BlockMax[ByteIndex] = FMath::Max(BlockMax[ByteIndex], Data[Offset + ByteIndex]);
+			}
+		}
+
+		for (int64 Offset = BlockedSize; Offset < Size; Offset++)
+		{
+			BlockMin[Offset % 4] = FMath::Min(BlockMin[Offset % 4], Data[Offset]);
+			BlockMax[Offset % 4] = FMath::Max(BlockMax[Offset % 4], Data[Offset]);
+		}
+
+		uint8 Mid[4];
+
+		for (int32 Channel = 0; Channel < 4; Channel++)
+		{
+			uint8 ChannelMin = BlockMin[Channel];
+			uint8 ChannelMax = BlockMax[Channel];
+
+			for (int32 ByteIndex = Channel + 4; ByteIndex < BlockSize; ByteIndex += 4)
+			{
+				ChannelMin = FMath::Min(ChannelMin, BlockMin[ByteIndex]);
+				ChannelMax = FMath::Max(ChannelMax, BlockMax[ByteIndex]);
+			}
+
+			if (ChannelMax - ChannelMin > Tolerance)
+			{
+				return false;
+			}
+
+			Mid[Channel] = (ChannelMin + ChannelMax + 1) / 2;
+		}
+
+		const FColor Color(Mid[2], Mid[1], Mid[0], Mid[3]);
+		OutColor = Image.GammaSpace == EGammaSpace::sRGB ? FLinearColor(Color) : Color.ReinterpretAsLinear();
+		return true;
+	}
+
+	/** Material slot index to the LOD its bake uses, in the order the slots are first used */
+	TMap<int32, int32> GetBakeLodIndices(const UStaticMesh& StaticMesh, EExportLodStrategy LodStrategy)
+	{
+		TMap<int32, int32> MaterialIndicesToLodIndices;
+		TMap<int32, uint32> MaterialIndicesToTriangleCounts;
+
+		const FStaticMeshRenderData* RenderData = StaticMesh.GetRenderData();
+		const int32 LodCount = LodStrategy == EExportLodStrategy::Lod0Only ? FMath::Min(StaticMesh.GetNumLODs(), 1) : StaticMesh.GetNumLODs();
+
+		for (int32 LodIndex = 0; LodIndex < LodCount; LodIndex++)
+		{
+			// Sections of the same slot within a LOD add up, without render data every slot stays at its first LOD
+			TMap<int32, uint32> LodTriangleCounts;
+			const int32 SectionCount = StaticMesh.GetNumSections(LodIndex);
+
+			for (int32 SectionIndex = 0; SectionIndex < SectionCount; SectionIndex++)
+			{
+				const int32 MaterialIndex = StaticMesh.GetSectionInfoMap().Get(LodIndex, SectionIndex).MaterialIndex;
+				const bool bHasTriangleCount = RenderData && RenderData->LODResources.IsValidIndex(LodIndex) && RenderData->LODResources[LodIndex].Sections.IsValidIndex(SectionIndex);
+				LodTriangleCounts.FindOrAdd(MaterialIndex) += bHasTriangleCount ? RenderData->LODResources[LodIndex].Sections[SectionIndex].NumTriangles : 0;
+			}
+
+			for (const auto& [MaterialIndex, TriangleCount] : LodTriangleCounts)
+			{
+				const uint32* MostTriangleCount = MaterialIndicesToTriangleCounts.Find(MaterialIndex);
+
+				if (!MostTriangleCount || (LodStrategy == EExportLodStrategy::AllLods && TriangleCount > *MostTriangleCount))
+				{
+					MaterialIndicesToLodIndices.Add(MaterialIndex, LodIndex);
+					MaterialIndicesToTriangleCounts.Add(MaterialIndex, TriangleCount);
+				}
+			}
+		}
+
+		return MaterialIndicesToLodIndices;
+	}
+
+	/** Flat images become the constant the material would use instead, mask map properties are kept until the whole material is known */
+	void AddTextureImage(FImage&& Image, bool bHasVectorConst, bool bHasScalarConst, FUnrealToUnityExporterTextureDescriptor& TextureDescriptor, TMap<FString, FImage>& MaskMapImages, FUnrealToUnityExporterTextureWriter& TextureWriter, const FExportSettings& ExportSettings, FUnrealToUnityExporterExportReportAsset& ReportAsset)
+	{
+		FLinearColor UniformColor;
+
+		if (ExportSettings.bUniformTexturesAsConstants && (bHasVectorConst || bHasScalarConst) && IsImageUniform(Image, ExportSettings.UniformTextureTolerance, UniformColor))
+		{
+			TextureDescriptor.bUseTexture = false;
+			TextureDescriptor.bUseColor = bHasVectorConst;
+			TextureDescriptor.bUseScalar = bHasScalarConst;
+			TextureDescriptor.Color = UniformColor;
+			TextureDescriptor.Scalar = UniformColor.R;
+		}
+		else if (ExportSettings.bPackMaskMaps && IsMaskMapProperty(TextureDescriptor.ParameterName))
+		{
+			MaskMapImages.Add(TextureDescriptor.ParameterName, MoveTemp(Image));
+		}
+		else
+		{
+			const EUnrealToUnityExporterTextureFormat TextureFormat = GetTextureFormat(TextureDescriptor.ParameterName, Image, ExportSettings);
+			TextureDescriptor.TextureFormat = FUnrealToUnityExporterBlockCompression::GetFormatName(TextureFormat);
+			TextureDescriptor.TexturePath = TextureWriter.Write(MoveTemp(Image), TextureFormat);
+			ReportAsset.TextureCount++;
+		}
+	}
+
+	/** Constant only properties don't need a texture at all, they stay as they are */
+	void WriteMaskMap(const TMap<FString, FImage>& MaskMapImages, FUnrealToUnityExporterMaterialDescriptor& MaterialDescriptor, FUnrealToUnityExporterTextureWriter& TextureWriter, const FExportSettings& ExportSettings, FUnrealToUnityExporterExportReportAsset& ReportAsset)
+	{
+		if (MaskMapImages.IsEmpty())
+		{
+			return;
+		}
+
+		FImage MaskMap = CreateMaskMap(MaskMapImages, MaterialDescriptor.TextureDescriptors);
+		const EUnrealToUnityExporterTextureFormat MaskMapFormat = GetTextureFormat(TEXT("MaskMap"), MaskMap, ExportSettings);
+		MaterialDescriptor.MaskMapFormat = FUnrealToUnityExporterBlockCompression::GetFormatName(MaskMapFormat);
+		MaterialDescriptor.MaskMapPath = TextureWriter.Write(MoveTemp(MaskMap), MaskMapFormat);
+		ReportAsset.TextureCount++;
+
+		MaterialDescriptor.TextureDescriptors.RemoveAll([] (const FUnrealToUnityExporterTextureDescriptor& TextureDescriptor)
+		{
+			return IsMaskMapProperty(TextureDescriptor.ParameterName);
+		});
+	}
+
+	/** Baked properties, named like the parameters of the baked material */
+	struct FPassThroughProperty
+	{
+		EMaterialProperty Property;
+		const TCHAR* ParameterName;
+		bool bIsColor;
+		bool bHasConst;
+	};
+
+	constexpr FPassThroughProperty PassThroughProperties[] = {
+		{ MP_BaseColor, TEXT("BaseColor"), true, true },
+		{ MP_Metallic, TEXT("Metallic"), false, true },
+		{ MP_Specular, TEXT("Specular"), false, true },
+		{ MP_Roughness, TEXT("Roughness"), false, true },
+		{ MP_Normal, TEXT("Normal"), true, false },
+		{ MP_Opacity, TEXT("Opacity"), false, true },
+		{ MP_OpacityMask, TEXT("OpacityMask"), false, true },
+		{ MP_EmissiveColor, TEXT("EmissiveColor"), true, true },
+	};
+
+	struct FPassThroughInput
+	{
+		/** Null for constants */
+		UTexture2D* Texture = nullptr;
+		/** 0 for RGB, 1 - 4 for a single channel */
+		int32 Channel = 0;
+		FLinearColor Constant = FLinearColor::Black;
+	};
+
+	/** Only succeeds if the property is unconnected or directly reads a texture or constant with UVs the bake would use too */
+	bool GetPassThroughInput(UMaterialInterface& MaterialInterface, const FPassThroughProperty& PassThroughProperty, FPassThroughInput& OutInput)
+	{
+		OutInput = FPassThroughInput();
+
+		UMaterial* Material = MaterialInterface.GetMaterial();
+
+		if (!Material || Material->bUseMaterialAttributes)
+		{
+			return false;
+		}
+
+		const FExpressionInput* ExpressionInput = Material->GetExpressionInputForProperty(PassThroughProperty.Property);
+
+		if (!ExpressionInput || !ExpressionInput->Expression || !MaterialInterface.IsPropertyActive(PassThroughProperty.Property))
+		{
+			const auto DefaultValue = FMaterialAttributeDefinitionMap::GetDefaultValue(PassThroughProperty.Property);
+			OutInput.Constant = FLinearColor(DefaultValue.X, DefaultValue.Y, DefaultValue.Z, DefaultValue.W);
+			return true;
+		}
+
+		// Colors need all of RGB, scalars read a single channel and take R of anything wider like the material compiler does
+		const int32 OutputIndex = ExpressionInput->OutputIndex;
+
+		if (PassThroughProperty.bIsColor ? OutputIndex != 0 : OutputIndex > 4)
+		{
+			return false;
+		}
+
+		OutInput.Channel = PassThroughProperty.bIsColor ? 0 : FMath::Max(OutputIndex, 1);
+
+		UMaterialExpression* Expression = ExpressionInput->Expression;
+		UMaterialExpressionTextureSample* TextureSample = ExactCast<UMaterialExpressionTextureSample>(Expression);
+		UMaterialExpressionTextureSampleParameter2D* TextureParameter = ExactCast<UMaterialExpressionTextureSampleParameter2D>(Expression);
+
+		if (TextureSample || TextureParameter)
+		{
+			TextureSample = TextureSample ? TextureSample : TextureParameter;
+
+			if (TextureSample->Coordinates.IsConnected() || TextureSample->TextureObject.IsConnected() || TextureSample->MipValue.IsConnected() || TextureSample->ConstCoordinate != 0)
+			{
+				return false;
+			}
+
+			UTexture* Texture = TextureSample->Texture;
+
+			if (TextureParameter && !MaterialInterface.GetTextureParameterValue(FMaterialParameterInfo(TextureParameter->ParameterName), Texture))
+			{
+				return false;
+			}
+
+			// Flipped green channels and UDIMs aren't what a single source image holds
+			OutInput.Texture = Cast<UTexture2D>(Texture);
+			return OutInput.Texture && OutInput.Texture->Source.IsValid() && OutInput.Texture->Source.GetNumBlocks() == 1 && !OutInput.Texture->bFlipGreenChannel;
+		}
+
+		FLinearColor Value;
+
+		if (const UMaterialExpressionScalarParameter* ScalarParameter = ExactCast<UMaterialExpressionScalarParameter>(Expression))
+		{
+			float ScalarValue;
+			if (!MaterialInterface.GetScalarParameterValue(FMaterialParameterInfo(ScalarParameter->ParameterName), ScalarValue))
+			{
+				return false;
+			}
+
+			Value = FLinearColor(ScalarValue, ScalarValue, ScalarValue, ScalarValue);
+		}
+		else if (const UMaterialExpressionVectorParameter* VectorParameter = ExactCast<UMaterialExpressionVectorParameter>(Expression))
+		{
+			if (!MaterialInterface.GetVectorParameterValue(FMaterialParameterInfo(VectorParameter->ParameterName), Value))
+			{
+				return false;
+			}
+		}
+		else if (const UMaterialExpressionConstant* Constant = ExactCast<UMaterialExpressionConstant>(Expression))
+		{
+			Value = FLinearColor(Constant->R, Constant->R, Constant->R, Constant->R);
+		}
+		else if (const UMaterialExpressionConstant3Vector* Constant3Vector = ExactCast<UMaterialExpressionConstant3Vector>(Expression))
+		{
+			Value = Constant3Vector->Constant;
+		}
+		else if (const UMaterialExpressionConstant4Vector* Constant4Vector = ExactCast<UMaterialExpressionConstant4Vector>(Expression))
+		{
+			Value = Constant4Vector->Constant;
+		}
+		else
+		{
+			return false;
+		}
+
+		OutInput.Constant = OutInput.Channel == 0 ? Value : FLinearColor(FVector3f(Value.Component(OutInput.Channel - 1)));
+		return true;
+	}
+
+	bool IsPassThroughMaterial(UMaterialInterface& MaterialInterface)
+	{
+		FPassThroughInput Input;
+
+		for (const FPassThroughProperty& PassThroughProperty : PassThroughProperties)
+		{
+			if (!GetPassThroughInput(MaterialInterface, PassThroughProperty, Input))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/** Scalar properties are baked into every color channel, in linear space like the sampler returns them */
+	FImage ExtractChannel(const FImage& Image, int32 Channel)
+	{
+		FImage ChannelImage;
+		Image.CopyTo(ChannelImage, ERawImageFormat::BGRA8, EGammaSpace::Linear);
+
+		for (FColor& Color : ChannelImage.AsBGRA8())
+		{
+			const uint8 Value = Channel == 1 ? Color.R : Channel == 2 ? Color.G : Channel == 3 ? Color.B : Color.A;
+			Color = FColor(Value, Value, Value, 255);
+		}
+
+		return ChannelImage;
+	}
+
+	struct FMaterialBake
+	{
+		FMaterialData MaterialData;
+		FMeshData MeshData;
+		/** Shared with the other bakes of the same mesh LOD */
+		TSharedPtr<FMeshDescription> MeshDescription;
+		FUnrealToUnityExporterMaterialData BakedMaterialData;
+	};
+	
+	struct FMaterialBakeKey
+	{
+		FMaterialBakeKey(const FString& InCanonicalMaterialKey, const FMaterialData& MaterialData)
+			: CanonicalMaterialKey(InCanonicalMaterialKey)
+		{
+			MaterialData.PropertySizes.GenerateKeyArray(Properties);
+			Properties.Sort();
+
+			for (const EMaterialProperty Property : Properties)
+			{
+				PropertySizes.Add(MaterialData.PropertySizes[Property]);
+			}
+		}
+
+		bool operator==(const FMaterialBakeKey& Other) const
+		{
+			return CanonicalMaterialKey == Other.CanonicalMaterialKey && Properties == Other.Properties && PropertySizes == Other.PropertySizes;
+		}
+
+		friend uint32 GetTypeHash(const FMaterialBakeKey& Key)
+		{
+			uint32 Hash = GetTypeHash(Key.CanonicalMaterialKey);
+
+			for (int32 PropertyIndex = 0; PropertyIndex < Key.Properties.Num(); PropertyIndex++)
+			{
+				Hash = HashCombine(Hash, GetTypeHash(Key.Properties[PropertyIndex]));
+				Hash = HashCombine(Hash, GetTypeHash(Key.PropertySizes[PropertyIndex]));
+			}
+
+			return Hash;
+		}
+
+		/** Equivalent materials share it, see GetCanonicalMaterialKey */
+		FString CanonicalMaterialKey;
+		TArray<EMaterialProperty> Properties;
+		TArray<FIntPoint> PropertySizes;
+	};
+}
+
 void FUnrealToUnityExporterModule::StartupModule()
 {
+	if (IsRunningCommandlet())
+	{
+		return;
+	}
+	
 	UToolMenu* Menu = UToolMenus::Get()->ExtendMenu("MainFrame.MainMenu");
 	UToolMenu* SubMenu = Menu->AddSubMenu("MainMenu", NAME_None, "UnrealToUnityExporter", LOCTEXT("UnrealToUnityExporterEntryLabel", "Unreal to Unity Exporter"));
 	SubMenu->AddMenuEntry(NAME_None,
@@ -38,195 +671,858 @@ void FUnrealToUnityExporterModule::ShutdownModule()
 void FUnrealToUnityExporterModule::OpenExportSettingsWindow()
 {
 	const TSharedRef<SExportSettingsWindow> ExportSettingsWindow = SNew(SExportSettingsWindow)
-		.OnExportSettingsDone_Static(RunUnrealToUnityExporter);
+		.OnExportSettingsDone_Lambda([] (const FExportSettings& ExportSettings)
+		{
+			RunUnrealToUnityExporter(ExportSettings);
+		});
 	FSlateApplication::Get().AddWindow(ExportSettingsWindow);
 }
 
-void FUnrealToUnityExporterModule::RunUnrealToUnityExporter(const FExportSettings& ExportSettings)
-{
-	TArray<UStaticMesh*> StaticMeshes;
-	Algo::TransformIf(ExportSettings.SelectedAssets, StaticMeshes, [] (const TSharedPtr<FAssetData>& AssetData)
+bool FUnrealToUnityExporterModule::RunUnrealToUnityExporter(const FExportSettings& ExportSettings)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_Export);
+
+	FUnrealToUnityExporterExportReport Report;
+	const double StartSeconds = FPlatformTime::Seconds();
+
+	// Registry class check, meshes are loaded shortly before their batch is baked
+	TArray<FAssetData> StaticMeshes;
+	Algo::TransformIf(ExportSettings.SelectedAssets, StaticMeshes, [] (const TSharedPtr<FAssetData>& AssetData)
+	{
+		return AssetData && AssetData->IsInstanceOf(UStaticMesh::StaticClass());
+	}, [] (const TSharedPtr<FAssetData>& AssetData)
+	{
+		return *AssetData;
+	});
+
+	const FString RelativeExportDirectory = ExportSettings.ExportDirectory.IsEmpty() ? FPaths::ProjectSavedDir() / TEXT("UnrealToUnityExporter") : ExportSettings.ExportDirectory;
+	const FString ExportDirectory = IFileManager::Get().ConvertToAbsolutePathForExternalAppForWrite(*RelativeExportDirectory);
+
+	const int32 MeshesPerBatch = FMath::Max(ExportSettings.MeshesPerBatch, 1);
+	const int32 BatchCount = FMath::DivideAndRoundUp(StaticMeshes.Num(), MeshesPerBatch);
+
+	FScopedSlowTask SlowTask(BatchCount + 1, LOCTEXT("BakeOutStaticMeshesSlowTask", "Baking out meshes"));
+
+	if (!IsRunningCommandlet())
+	{
+		SlowTask.MakeDialog();
+	}
+
+	bool bIsSucceeded = true;
+
+	FUnrealToUnityExporterDescriptorWriter DescriptorWriter(ExportDirectory, ExportSettings.bBinaryImportDescriptor);
+	bIsSucceeded &= DescriptorWriter.Open();
+
+	// Unity imports every announced file while the export keeps running
+	FUnrealToUnityExporterImportNotifier ImportNotifier;
+
+	if (ExportSettings.bNotifyUnity)
+	{
+		ImportNotifier.Begin(ExportDirectory);
+	}
+
+	const FString SettingsHash = FUnrealToUnityExporterExportCache::GetExportSettingsHash(ExportSettings);
+
+	// Meshes which didn't change since the last export keep their files and descriptors
+	FUnrealToUnityExporterExportCache ExportCache(ExportDirectory, ExportSettings);
+
+	if (ExportSettings.bUseExportCache)
+	{
+		ExportCache.Load();
+	}
+
+	// Meshes and materials completed by an interrupted export are picked up from the journal
+	FUnrealToUnityExporterExportJournal ExportJournal(ExportDirectory, SettingsHash);
+
+	if (ExportSettings.bResumeExport)
+	{
+		ExportJournal.Load();
+	}
+
+	ExportJournal.Open(ExportSettings.bResumeExport);
+
+	TMap<FName, FUnrealToUnityExporterMaterialData> OriginalPathsToMaterialData;
+	TMap<FName, FUnrealToUnityExporterMaterialDescriptor> OriginalPathsToMaterialDescriptors = ExportJournal.GetCompletedMaterials();
+
+	// Merged materials were journaled with the descriptor of their equivalent, its file name tells which one that is
+	TMap<FString, FName> BakedNamesToMaterialNames;
+
+	for (const auto& [OriginalPath, MaterialDescriptor] : OriginalPathsToMaterialDescriptors)
+	{
+		const FString BakedMaterialName = FPaths::GetBaseFilename(MaterialDescriptor.MaterialPath);
+
+		if (BakedMaterialName == GetBakedMaterialName(OriginalPath))
+		{
+			BakedNamesToMaterialNames.Add(BakedMaterialName, OriginalPath);
+		}
+	}
+
+	for (const auto& [OriginalPath, MaterialDescriptor] : OriginalPathsToMaterialDescriptors)
+	{
+		FUnrealToUnityExporterMaterialData& MaterialData = OriginalPathsToMaterialData.Add(OriginalPath);
+		MaterialData.OriginalMaterialName = OriginalPath;
+		MaterialData.bIsExported = true;
+
+		if (const FName* CanonicalMaterialName = BakedNamesToMaterialNames.Find(FPaths::GetBaseFilename(MaterialDescriptor.MaterialPath)); CanonicalMaterialName && *CanonicalMaterialName != OriginalPath)
+		{
+			MaterialData.CanonicalMaterialName = *CanonicalMaterialName;
+			continue;
+		}
+
+		DescriptorWriter.AddMaterial(MaterialDescriptor);
+		ImportNotifier.NotifyMaterial(MaterialDescriptor);
+	}
+
+	TArray<FAssetData> StaticMeshesToExport;
+	TArray<FAssetData> ResumedStaticMeshes;
+
+	for (const FAssetData& StaticMesh : StaticMeshes)
+	{
+		const FUnrealToUnityExporterExportCacheEntry* CacheEntry = ExportSettings.bUseExportCache ? ExportCache.FindUpToDateEntry(StaticMesh) : nullptr;
+
+		if (CacheEntry)
+		{
+			for (const FUnrealToUnityExporterMaterialDescriptor& MaterialDescriptor : CacheEntry->MaterialDescriptors)
+			{
+				DescriptorWriter.AddMaterial(MaterialDescriptor);
+				ImportNotifier.NotifyMaterial(MaterialDescriptor);
+			}
+
+			DescriptorWriter.AddMesh(CacheEntry->MeshDescriptor);
+			ImportNotifier.NotifyMesh(CacheEntry->MeshDescriptor);
+			Report.Data.CachedMeshCount++;
+		}
+		else if (const FUnrealToUnityExporterMeshDescriptor* JournalMeshDescriptor = ExportJournal.GetCompletedMeshes().Find(StaticMesh.GetObjectPathString()))
+		{
+			DescriptorWriter.AddMesh(*JournalMeshDescriptor);
+			ImportNotifier.NotifyMesh(*JournalMeshDescriptor);
+			ResumedStaticMeshes.Add(StaticMesh);
+			Report.Data.ResumedMeshCount++;
+		}
+		else
+		{
+			StaticMeshesToExport.Add(StaticMesh);
+		}
+	}
+
+	FUnrealToUnityExporterTextureWriter TextureWriter(ExportDirectory, ExportSettings.TextureWriterThreads, ExportSettings.TextureWriterQueueSize, GetPngQuality(ExportSettings.PngCompression));
+	FUnrealToUnityExporterFbxWorkers FbxWorkers(ExportDirectory / TEXT("FbxWorkers"), ExportSettings.MeshExportProcesses);
+
+	// The next batch is loading while the current one is baked and exported
+	FUnrealToUnityExporterAssetLoader AssetLoader(StaticMeshesToExport, MeshesPerBatch * 2);
+
+	// Meshes are processed in batches so the journal can record progress while the export is still running
+	for (int32 BatchStartIndex = 0; BatchStartIndex < StaticMeshesToExport.Num(); BatchStartIndex += MeshesPerBatch)
+	{
+		const int32 BatchMeshCount = FMath::Min(MeshesPerBatch, StaticMeshesToExport.Num() - BatchStartIndex);
+
+		SlowTask.EnterProgressFrame(1.f, FText::Format(LOCTEXT("ExportBatchSlowTask", "Exporting meshes {0} - {1} of {2}"), BatchStartIndex + 1, BatchStartIndex + BatchMeshCount, StaticMeshesToExport.Num()));
+		TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_Batch);
+
+		TArray<UStaticMesh*> BatchStaticMeshes;
+		{
+			FScopedDurationTimer LoadTimer(Report.Data.LoadSeconds);
+			Algo::Transform(AssetLoader.LoadBatch(BatchStartIndex, BatchMeshCount), BatchStaticMeshes, [] (UObject* Asset)
+			{
+				return CastChecked<UStaticMesh>(Asset);
+			});
+		}
+
+		bIsSucceeded &= BatchStaticMeshes.Num() == BatchMeshCount;
+
+		TArray<UStaticMesh*> BakedStaticMeshes;
+		TArray<bool> AreMeshesBaked;
+		BakeOutStaticMeshes(BatchStaticMeshes, OriginalPathsToMaterialData, ExportCache, ExportSettings, BakedStaticMeshes, AreMeshesBaked, Report);
+		AssetLoader.ProcessLoads();
+		TArray<FUnrealToUnityExporterMeshDescriptor> BatchMeshDescriptors;
+		TArray<bool> AreMeshesExported;
+		bIsSucceeded &= ExportMeshes(BatchStaticMeshes, BakedStaticMeshes, ExportDirectory, BatchMeshDescriptors, AreMeshesExported, FbxWorkers, ExportSettings, Report);
+		AssetLoader.ProcessLoads();
+		ExportMaterials(OriginalPathsToMaterialData, DescriptorWriter, OriginalPathsToMaterialDescriptors, TextureWriter, ExportSettings, Report);
+
+		// Nothing is recorded before its files are on disk, the next batch keeps loading meanwhile
+		{
+			TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_FlushTextures);
+
+			while (!TextureWriter.Flush(FTimespan::FromMilliseconds(10.0)))
+			{
+				AssetLoader.ProcessLoads();
+			}
+		}
+
+		// Materials with missing files are baked again by a resumed export, together with the meshes using them
+		TSet<FName> UnwrittenMaterialNames;
+
+		for (const auto& [OriginalPath, MaterialDescriptor] : OriginalPathsToMaterialDescriptors)
+		{
+			if (!ExportJournal.GetCompletedMaterials().Contains(OriginalPath))
+			{
+				if (!AreMaterialFilesWritten(MaterialDescriptor, TextureWriter))
+				{
+					UnwrittenMaterialNames.Add(OriginalPath);
+					continue;
+				}
+
+				ExportJournal.AddMaterial(OriginalPath, MaterialDescriptor);
+
+				// Merged materials share the files of their equivalent, which Unity is already told about
+				if (OriginalPathsToMaterialData[OriginalPath].CanonicalMaterialName.IsNone())
+				{
+					ImportNotifier.NotifyMaterial(MaterialDescriptor);
+				}
+			}
+		}
+
+		for (int32 MeshIndex = 0; MeshIndex < BatchStaticMeshes.Num(); MeshIndex++)
+		{
+			// Left out of the journal and the cache, a resumed or later export tries them again
+			const bool bHasUnwrittenMaterial = BatchStaticMeshes[MeshIndex]->GetStaticMaterials().ContainsByPredicate([&UnwrittenMaterialNames] (const FStaticMaterial& StaticMaterial)
+			{
+				return StaticMaterial.MaterialInterface && UnwrittenMaterialNames.Contains(StaticMaterial.MaterialInterface->GetPackage()->GetFName());
+			});
+
+			if (!AreMeshesBaked[MeshIndex] || !AreMeshesExported[MeshIndex] || bHasUnwrittenMaterial)
+			{
+				bIsSucceeded = false;
+				continue;
+			}
+
+			ExportJournal.AddMesh(BatchStaticMeshes[MeshIndex]->GetPathName(), BatchMeshDescriptors[MeshIndex]);
+			Report.Data.ExportedMeshCount++;
+			DescriptorWriter.AddMesh(BatchMeshDescriptors[MeshIndex]);
+			ImportNotifier.NotifyMesh(BatchMeshDescriptors[MeshIndex]);
+		}
+
+		ExportJournal.Flush();
+
+		// Releases the batch's transient meshes, materials and textures, later batches get placeholders for materials which are already exported
+		TSet<UPackage*> BakedMaterialsPackages;
+
+		for (auto& [OriginalPath, MaterialData] : OriginalPathsToMaterialData)
+		{
+			if (MaterialData.BakedMaterialInterface)
+			{
+				BakedMaterialsPackages.Add(MaterialData.BakedMaterialInterface->GetPackage());
+			}
+
+			MaterialData.BakedMaterialInterface = nullptr;
+			MaterialData.PassThroughMaterialInterface = nullptr;
+		}
+
+		// Proxy materials and their textures are created standalone, which garbage collection would keep otherwise
+		for (UPackage* BakedMaterialsPackage : BakedMaterialsPackages)
+		{
+			ForEachObjectWithPackage(BakedMaterialsPackage, [] (UObject* Object)
+			{
+				Object->ClearFlags(RF_Public | RF_Standalone);
+				Object->MarkAsGarbage();
+				return true;
+			});
+		}
+
+		BakedStaticMeshes.Empty();
+		BatchStaticMeshes.Empty();
+		AssetLoader.ReleaseBatch(BatchStartIndex, BatchMeshCount);
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	if (ExportSettings.bUseExportCache)
+	{
+		for (const FAssetData& StaticMesh : ResumedStaticMeshes)
+		{
+			ExportCache.UpdateEntry(StaticMesh.GetObjectPathString(), ExportJournal.GetCompletedMeshes()[StaticMesh.GetObjectPathString()], OriginalPathsToMaterialDescriptors);
+		}
+
+		// Meshes which couldn't be loaded, baked or exported aren't in the journal
+		for (const FAssetData& StaticMesh : StaticMeshesToExport)
+		{
+			if (const FUnrealToUnityExporterMeshDescriptor* MeshDescriptor = ExportJournal.GetCompletedMeshes().Find(StaticMesh.GetObjectPathString()))
+			{
+				ExportCache.UpdateEntry(StaticMesh.GetObjectPathString(), *MeshDescriptor, OriginalPathsToMaterialDescriptors);
+			}
+		}
+
+		if (!ExportCache.Save())
+		{
+			UE_LOG(LogTemp, Error, TEXT("Export cache couldn't be saved"));
+		}
+	}
+
+	SlowTask.EnterProgressFrame(1.f, LOCTEXT("SaveImportDescriptorSlowTask", "Saving mesh import descriptor"));
+	FString ImportDescriptorSavePath;
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_SaveDescriptor);
+		FScopedDurationTimer Timer(Report.Data.DescriptorSaveSeconds);
+		ImportDescriptorSavePath = DescriptorWriter.Finish();
+	}
+
+	bIsSucceeded &= !ImportDescriptorSavePath.IsEmpty() && TextureWriter.GetErrorCount() == 0;
+
+	// Kept after a failed export so the failed meshes can be retried with a resume
+	if (bIsSucceeded)
 	{
-		return AssetData && AssetData->GetAsset()->IsA<UStaticMesh>();
-	}, [] (const TSharedPtr<FAssetData>& AssetData)
+		ExportJournal.Finish();
+	}
+
+	// Unity not running doesn't make the export fail, it can still import the descriptor later
+	if (ExportSettings.bNotifyUnity && !ImportNotifier.Finish(ImportDescriptorSavePath))
 	{
-		return Cast<UStaticMesh>(AssetData->GetAsset());
-	});
+		UE_LOG(LogTemp, Warning, TEXT("Unity importer couldn't be notified, the export can be imported from %s"), *ImportDescriptorSavePath);
+	}
 
-	const FString RelativeExportDirectory = FPaths::ProjectSavedDir() / TEXT("UnrealToUnityExporter");
-	const FString ExportDirectory = IFileManager::Get().ConvertToAbsolutePathForExternalAppForWrite(*RelativeExportDirectory);
+	IFileManager& FileManager = IFileManager::Get();
+	const FUnrealToUnityExporterTextureWriterStats TextureWriterStats = TextureWriter.GetStats();
 
-	FUnrealToUnityExporterImportDescriptor ImportDescriptor;
-	ImportDescriptor.ExportDirectory = ExportDirectory;
+	Report.Data.EncodeSeconds = TextureWriterStats.EncodeSeconds;
+	Report.Data.WriteSeconds = TextureWriterStats.WriteSeconds;
+	Report.Data.WrittenTextureCount = TextureWriterStats.WrittenImageCount;
+	Report.Data.ReusedTextureCount = TextureWriterStats.ReusedImageCount;
+	Report.Data.TextureBytesWritten = TextureWriterStats.BytesWritten;
+	Report.Data.NotifySeconds = ImportNotifier.GetBusySeconds();
+	Report.Data.BytesWritten += TextureWriterStats.BytesWritten + FMath::Max<int64>(FileManager.FileSize(*ImportDescriptorSavePath), 0);
 
-	FScopedSlowTask SlowTask(5, LOCTEXT("BakeOutStaticMeshesSlowTask", "Baking out meshes"));
-	SlowTask.MakeDialog();
+	for (FUnrealToUnityExporterExportReportAsset& Asset : Report.Data.Assets)
+	{
+		const FUnrealToUnityExporterMaterialDescriptor* MaterialDescriptor = OriginalPathsToMaterialDescriptors.Find(FName(Asset.AssetPath));
 
-	TMap<FName, FUnrealToUnityExporterMaterialData> OriginalPathsToMaterialData;
-	
-	SlowTask.EnterProgressFrame(1.f);
-	BakeOutStaticMeshes(StaticMeshes, OriginalPathsToMaterialData, ExportSettings);
+		if (!MaterialDescriptor)
+		{
+			continue;
+		}
+
+		for (const FUnrealToUnityExporterTextureDescriptor& TextureDescriptor : MaterialDescriptor->TextureDescriptors)
+		{
+			if (!TextureDescriptor.TexturePath.IsEmpty())
+			{
+				Asset.BytesWritten += FMath::Max<int64>(FileManager.FileSize(*(ExportDirectory / TextureDescriptor.TexturePath)), 0);
+			}
+		}
 
-	SlowTask.EnterProgressFrame(1.f, LOCTEXT("ExportMeshesSlowTask", "Exporting meshes"));
-	ExportMeshes(StaticMeshes, ExportDirectory, ImportDescriptor, ExportSettings);
+		if (!MaterialDescriptor->MaskMapPath.IsEmpty())
+		{
+			Asset.BytesWritten += FMath::Max<int64>(FileManager.FileSize(*(ExportDirectory / MaterialDescriptor->MaskMapPath)), 0);
+		}
+	}
 
-	SlowTask.EnterProgressFrame(1.f, LOCTEXT("ExportMaterialsSlowTask", "Exporting materials"));
-	ExportMaterials(OriginalPathsToMaterialData, ExportDirectory, ImportDescriptor);
+	Report.Data.TotalSeconds = FPlatformTime::Seconds() - StartSeconds;
 
-	SlowTask.EnterProgressFrame(1.f, LOCTEXT("SaveImportDescriptorSlowTask", "Saving mesh import descriptor"));
-	const FString ImportDescriptorSavePath = SaveImportDescriptor(ImportDescriptor, ExportDirectory);
+	if (!Report.Save(ExportDirectory))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Export report couldn't be saved"));
+	}
 
-	SendUnityImportMessage(ImportDescriptorSavePath);
-	
-	SlowTask.EnterProgressFrame(1.f, LOCTEXT("RevertMeshesSlowTask", "Reverting mesh changes"));
-    // TODO: Consider implement
-    //TArray<UMaterialInterface*> GeneratedMaterials;
-    //OriginalPathsToMaterialData.GenerateValueArray(GeneratedMaterials);
-    RevertChanges(StaticMeshes, {} /*GeneratedMaterials*/);
+	return bIsSucceeded;
 }
 
-void FUnrealToUnityExporterModule::BakeOutStaticMeshes(const TArrayView<UStaticMesh*> StaticMeshes, TMap<FName, FUnrealToUnityExporterMaterialData>& OriginalPathsToMaterialData, const FExportSettings& ExportSettings)
+void FUnrealToUnityExporterModule::BakeOutStaticMeshes(const TArrayView<UStaticMesh*> StaticMeshes, TMap<FName, FUnrealToUnityExporterMaterialData>& OriginalPathsToMaterialData, FUnrealToUnityExporterExportCache& ExportCache, const FExportSettings& ExportSettings, TArray<UStaticMesh*>& OutBakedStaticMeshes, TArray<bool>& OutAreMeshesBaked, FUnrealToUnityExporterExportReport& Report)
 {
-	const IMeshMergeUtilities& MeshMergeUtilities = FModuleManager::Get().LoadModuleChecked<IMeshMergeModule>("MeshMergeUtilities").GetUtilities();
-	
-	FScopedTransaction Transaction(LOCTEXT("UnrealToUnityExporterDummyTransactionName", "Unreal to Unity Exporter Dummy Transaction"));
-	
-	for (UStaticMesh* StaticMesh : StaticMeshes)
-	{
-		UMaterialOptions* MaterialOptions = DuplicateObject(GetMutableDefault<UMaterialOptions>(), GetTransientPackage());
-		UAssetBakeOptions* AssetOptions = GetMutableDefault<UAssetBakeOptions>();
-		UMaterialMergeOptions* MergeOptions = GetMutableDefault<UMaterialMergeOptions>();
-		TArray<TWeakObjectPtr<>> Objects{ MergeOptions, AssetOptions, MaterialOptions };
+	TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_Bake);
+	FScopedDurationTimer BakeTimer(Report.Data.BakeSeconds);
 
-		TMap<int32, FUnrealToUnityExporterMaterialData> LodSectionHashToMaterialData;
+	IMaterialBakingModule& MaterialBakingModule = FModuleManager::Get().LoadModuleChecked<IMaterialBakingModule>("MaterialBaking");
 
-		auto GetHashFromLodSection = [](int32 LodIndex, int32 SectionIndex) -> int32
-		{
-			return LodIndex * 10000 + SectionIndex;
-		};
+	UMaterialOptions* MaterialOptions = DuplicateObject(GetMutableDefault<UMaterialOptions>(), GetTransientPackage());
+	MaterialOptions->TextureSize = FIntPoint(ExportSettings.TextureSize, ExportSettings.TextureSize);
+	MaterialOptions->Properties.Empty();
 		
-		for (int32 LodIndex = 0; LodIndex < StaticMesh->GetNumLODs(); LodIndex++)
+	MaterialOptions->Properties.Emplace(MP_BaseColor);
+	MaterialOptions->Properties.Emplace(MP_Metallic);
+	MaterialOptions->Properties.Emplace(MP_Specular);
+	MaterialOptions->Properties.Emplace(MP_Roughness);
+	MaterialOptions->Properties.Emplace(MP_Normal);
+	MaterialOptions->Properties.Emplace(MP_Opacity);
+	MaterialOptions->Properties.Emplace(MP_OpacityMask);
+	MaterialOptions->Properties.Emplace(MP_EmissiveColor);
+
+	UPackage* BakedMaterialsPackage = CreatePackage(*FString::Printf(TEXT("/Temp/UnrealToUnityExporter/%s"), *FGuid::NewGuid().ToString()));
+	BakedMaterialsPackage->SetFlags(RF_Transient);
+
+	// Every unique (equivalent material, texture size, property set) combination of the whole selection is baked exactly once
+	TArray<TUniquePtr<FMaterialBake>> MaterialBakes;
+	TMap<FMaterialBakeKey, int32> BakeKeysToBakeIndices;
+	TArray<TMap<int32, int32>> MaterialIndicesToBakeIndicesPerMesh;
+	TArray<TMap<int32, UMaterialInterface*>> MaterialIndicesToBakedMaterialsPerMesh;
+	// Every material of a mesh LOD needing mesh data renders the same description, it's built once for the batch
+	FUnrealToUnityExporterMeshDescriptionCache MeshDescriptionCache;
+	// Materials of earlier batches which equivalent ones are merged into
+	TMap<FString, FName> CanonicalKeysToMaterialNames;
+	MaterialIndicesToBakeIndicesPerMesh.SetNum(StaticMeshes.Num());
+	MaterialIndicesToBakedMaterialsPerMesh.SetNum(StaticMeshes.Num());
+
+	if (ExportSettings.bMergeEquivalentMaterials)
+	{
+		for (const auto& [OriginalPath, MaterialData] : OriginalPathsToMaterialData)
 		{
-			MaterialOptions->LODIndices.Add(LodIndex);	
+			if (!MaterialData.CanonicalMaterialKey.IsEmpty() && MaterialData.CanonicalMaterialName.IsNone())
+			{
+				CanonicalKeysToMaterialNames.Add(MaterialData.CanonicalMaterialKey, OriginalPath);
+			}
 		}
-		
-		MaterialOptions->TextureSize = FIntPoint(ExportSettings.TextureSize, ExportSettings.TextureSize);
-		MaterialOptions->Properties.Empty();
-			
-		MaterialOptions->Properties.Emplace(MP_BaseColor);
-		MaterialOptions->Properties.Emplace(MP_Metallic);
-		MaterialOptions->Properties.Emplace(MP_Specular);
-		MaterialOptions->Properties.Emplace(MP_Roughness);
-		MaterialOptions->Properties.Emplace(MP_Normal);
-		MaterialOptions->Properties.Emplace(MP_Opacity);
-		MaterialOptions->Properties.Emplace(MP_OpacityMask);
-		MaterialOptions->Properties.Emplace(MP_EmissiveColor);
-
-		{
-			const int32 LodCount = StaticMesh->GetNumLODs();
-			
-			for (int32 LodIndex = 0; LodIndex < LodCount; LodIndex++)
-			{
-				const int32 SectionCount = StaticMesh->GetNumSections(LodIndex);
-
-				for (int32 SectionIndex = 0; SectionIndex < SectionCount; SectionIndex++)
+	}
+
+	for (int32 MeshIndex = 0; MeshIndex < StaticMeshes.Num(); MeshIndex++)
+	{
+		UStaticMesh* StaticMesh = StaticMeshes[MeshIndex];
+
+		// Lower LODs mostly reuse the slots of LOD0, every slot is baked once
+		for (const auto& [MaterialIndex, LodIndex] : GetBakeLodIndices(*StaticMesh, ExportSettings.LodStrategy))
+		{
+			UMaterialInterface* MaterialInterface = StaticMesh->GetMaterial(MaterialIndex);
+
+			if (!MaterialInterface)
+			{
+				continue;
+			}
+
+			const FName OriginalMaterialName = MaterialInterface->GetPackage()->GetFName();
+			FUnrealToUnityExporterMaterialData* ExistingMaterialData = OriginalPathsToMaterialData.Find(OriginalMaterialName);
+			const FString CanonicalMaterialKey = ExportSettings.bMergeEquivalentMaterials ? GetCanonicalMaterialKey(*MaterialInterface) : MaterialInterface->GetPathName();
+
+			// Stands in for an equivalent material baked by an earlier batch or exported as a pass-through material
+			if (!ExistingMaterialData && ExportSettings.bMergeEquivalentMaterials)
+			{
+				if (const FName* CanonicalMaterialName = CanonicalKeysToMaterialNames.Find(CanonicalMaterialKey))
 				{
-					const FMeshSectionInfo& SectionInfo = StaticMesh->GetSectionInfoMap().Get(LodIndex, SectionIndex);
-					const int32 MaterialIndex = SectionInfo.MaterialIndex;
-					const FName OriginalMaterialName = StaticMesh->GetMaterial(MaterialIndex)->GetPackage()->GetFName();
-					const UMaterialInterface* MaterialInterface = StaticMesh->GetMaterial(MaterialIndex);
-					
-					FUnrealToUnityExporterMaterialData& MaterialData = LodSectionHashToMaterialData.FindOrAdd(GetHashFromLodSection(LodIndex, SectionIndex));
-					MaterialData.OriginalMaterialName = OriginalMaterialName;
-
-					if (MaterialInterface)
-					{
-						MaterialData.OriginalBlendMode = MaterialInterface->GetBlendMode();
-					}
+					FUnrealToUnityExporterMaterialData& MergedMaterialData = OriginalPathsToMaterialData.Add(OriginalMaterialName);
+					MergedMaterialData.OriginalMaterialName = OriginalMaterialName;
+					MergedMaterialData.CanonicalMaterialName = *CanonicalMaterialName;
+					ExistingMaterialData = &MergedMaterialData;
 				}
 			}
-		}
-		
-		// Bake out materials for static mesh asset
-		StaticMesh->Modify();
-		FUnrealToUnityExporterStaticMeshAdapter Adapter(StaticMesh);
-		MeshMergeUtilities.BakeMaterialsForComponent(Objects, &Adapter);
 
-		{
-			TSet<int32> ProcessedMaterialIndices;
-			TArray<FStaticMaterial> StaticMaterials = StaticMesh->GetStaticMaterials();
-			const int32 LodCount = StaticMesh->GetNumLODs();
-			
-			for (int32 LodIndex = 0; LodIndex < LodCount; LodIndex++)
+			// Merged materials use the bake of their equivalent, which isn't found yet while it's still pending in this batch
+			if (ExistingMaterialData && !ExistingMaterialData->CanonicalMaterialName.IsNone())
+			{
+				ExistingMaterialData = OriginalPathsToMaterialData.Find(ExistingMaterialData->CanonicalMaterialName);
+			}
+
+			// Baked by an earlier batch or by the interrupted export which is being resumed
+			if (ExistingMaterialData)
+			{
+				if (!ExistingMaterialData->BakedMaterialInterface)
+				{
+					// Its textures are already on disk, exported mesh only needs a material carrying the same name
+					UMaterialInstanceConstant* PlaceholderMaterial = NewObject<UMaterialInstanceConstant>(BakedMaterialsPackage, *GetBakedMaterialName(ExistingMaterialData->OriginalMaterialName), RF_Transient);
+					PlaceholderMaterial->SetParentEditorOnly(MaterialInterface);
+					ExistingMaterialData->BakedMaterialInterface = PlaceholderMaterial;
+				}
+
+				MaterialIndicesToBakedMaterialsPerMesh[MeshIndex].Add(MaterialIndex, ExistingMaterialData->BakedMaterialInterface);
+				continue;
+			}
+
+			// Nothing to render, textures are exported from their sources and the mesh only needs a material carrying the baked name
+			if (ExportSettings.bPassThroughMaterials && (!MaterialOptions->bUseSpecificUVIndex || MaterialOptions->TextureCoordinateIndex == 0) && IsPassThroughMaterial(*MaterialInterface))
+			{
+				FUnrealToUnityExporterMaterialData& PassThroughMaterialData = OriginalPathsToMaterialData.Add(MaterialInterface->GetPackage()->GetFName());
+				PassThroughMaterialData.OriginalMaterialName = MaterialInterface->GetPackage()->GetFName();
+				PassThroughMaterialData.OriginalBlendMode = MaterialInterface->GetBlendMode();
+				PassThroughMaterialData.PassThroughMaterialInterface = MaterialInterface;
+				PassThroughMaterialData.CanonicalMaterialKey = CanonicalMaterialKey;
+				CanonicalKeysToMaterialNames.Add(CanonicalMaterialKey, OriginalMaterialName);
+
+				UMaterialInstanceConstant* PlaceholderMaterial = NewObject<UMaterialInstanceConstant>(BakedMaterialsPackage, *GetBakedMaterialName(PassThroughMaterialData.OriginalMaterialName), RF_Transient);
+				PlaceholderMaterial->SetParentEditorOnly(MaterialInterface);
+				PassThroughMaterialData.BakedMaterialInterface = PlaceholderMaterial;
+
+				MaterialIndicesToBakedMaterialsPerMesh[MeshIndex].Add(MaterialIndex, PlaceholderMaterial);
+				continue;
+			}
+
+			FMaterialData MaterialData;
+			MaterialData.Material = MaterialInterface;
+
+			for (const FPropertyEntry& Entry : MaterialOptions->Properties)
+			{
+				if (!Entry.bUseConstantValue && Entry.Property != MP_MAX && IsPropertyUsed(*MaterialInterface, Entry.Property))
+				{
+					MaterialData.PropertySizes.Add(Entry.Property, Entry.bUseCustomSize ? Entry.CustomSize : MaterialOptions->TextureSize);
+				}
+			}
+
+			// Baking needs at least one property
+			if (MaterialData.PropertySizes.IsEmpty())
+			{
+				MaterialData.PropertySizes.Add(MP_BaseColor, MaterialOptions->TextureSize);
+			}
+
+			const FMaterialBakeKey BakeKey(CanonicalMaterialKey, MaterialData);
+
+			if (const int32* BakeIndex = BakeKeysToBakeIndices.Find(BakeKey))
 			{
-				const int32 SectionCount = StaticMesh->GetNumSections(LodIndex);
+				const FUnrealToUnityExporterMaterialData& BakedMaterialData = MaterialBakes[*BakeIndex]->BakedMaterialData;
 
-				for (int32 SectionIndex = 0; SectionIndex < SectionCount; SectionIndex++)
+				// An equivalent material of this batch, the merged one only gets its descriptor
+				if (BakedMaterialData.OriginalMaterialName != OriginalMaterialName && !OriginalPathsToMaterialData.Contains(OriginalMaterialName))
 				{
-					const FMeshSectionInfo& SectionInfo = StaticMesh->GetSectionInfoMap().Get(LodIndex, SectionIndex);
-					const int32 MaterialIndex = SectionInfo.MaterialIndex;
+					FUnrealToUnityExporterMaterialData& MergedMaterialData = OriginalPathsToMaterialData.Add(OriginalMaterialName);
+					MergedMaterialData.OriginalMaterialName = OriginalMaterialName;
+					MergedMaterialData.CanonicalMaterialName = BakedMaterialData.OriginalMaterialName;
+				}
+
+				MaterialIndicesToBakeIndicesPerMesh[MeshIndex].Add(MaterialIndex, *BakeIndex);
+				continue;
+			}
 
-					if (ProcessedMaterialIndices.Contains(MaterialIndex))
+			FMaterialBake& MaterialBake = *MaterialBakes.Add_GetRef(MakeUnique<FMaterialBake>());
+			MaterialBake.MaterialData = MoveTemp(MaterialData);
+			MaterialBake.MeshData.TextureCoordinateBox = FBox2D(FVector2D(0.f, 0.f), FVector2D(1.f, 1.f));
+			MaterialBake.MeshData.TextureCoordinateIndex = MaterialOptions->bUseSpecificUVIndex ? MaterialOptions->TextureCoordinateIndex : 0;
+
+			// Materials relying on mesh data are baked against the first mesh using them, the result is still shared
+			if (MaterialOptions->bUseMeshData)
+			{
+				FUnrealToUnityExporterStaticMeshAdapter Adapter(StaticMesh, &MeshDescriptionCache);
+				MaterialBake.MeshDescription = Adapter.GetSharedMeshDescription(LodIndex);
+				Adapter.ApplySettings(LodIndex, MaterialBake.MeshData);
+
+				const TArray<FSectionInfo>& Sections = MeshDescriptionCache.GetSections(StaticMesh, LodIndex);
+
+				for (int32 MeshSectionIndex = 0; MeshSectionIndex < Sections.Num(); MeshSectionIndex++)
+				{
+					if (Sections[MeshSectionIndex].Material == MaterialInterface)
 					{
-						continue;
+						MaterialBake.MeshData.MaterialIndices.Add(MeshSectionIndex);
 					}
-					
-					const int32 LodSectionHash = GetHashFromLodSection(LodIndex, SectionIndex);
-					FUnrealToUnityExporterMaterialData& MaterialData = LodSectionHashToMaterialData.FindOrAdd(LodSectionHash);
-					const FString OriginalMaterialPathStr = MaterialData.OriginalMaterialName.ToString();
-					const FString OriginalMaterialName = FPaths::GetCleanFilename(OriginalMaterialPathStr);
-					const FString MaterialName = FString::Printf(TEXT("%s_%s"), *OriginalMaterialName, *FMD5::HashAnsiString(*OriginalMaterialPathStr));
-					StaticMaterials[MaterialIndex].MaterialInterface = DuplicateObject(StaticMaterials[MaterialIndex].MaterialInterface, nullptr, FName(MaterialName));
-					ProcessedMaterialIndices.Add(MaterialIndex);
-					MaterialData.BakedMaterialInterface = StaticMaterials[MaterialIndex].MaterialInterface;
-					OriginalPathsToMaterialData.Add(MaterialData.OriginalMaterialName, MaterialData);
 				}
+
+				MaterialBake.MeshData.MeshDescription = MaterialBake.MeshDescription.Get();
 			}
 
-			StaticMesh->SetStaticMaterials(StaticMaterials);
+			FUnrealToUnityExporterMaterialData& BakedMaterialData = MaterialBake.BakedMaterialData;
+			BakedMaterialData.OriginalMaterialName = MaterialInterface->GetPackage()->GetFName();
+			BakedMaterialData.OriginalBlendMode = MaterialInterface->GetBlendMode();
+			BakedMaterialData.CanonicalMaterialKey = CanonicalMaterialKey;
+
+			const int32 NewBakeIndex = MaterialBakes.Num() - 1;
+			BakeKeysToBakeIndices.Add(BakeKey, NewBakeIndex);
+			MaterialIndicesToBakeIndicesPerMesh[MeshIndex].Add(MaterialIndex, NewBakeIndex);
+		}
+	}
+
+	auto CreateBakedMaterial = [&OriginalPathsToMaterialData, BakedMaterialsPackage, MaterialOptions] (FMaterialBake& MaterialBake, FBakeOutput& BakeOutput, const FString& BakeCacheKeyToPut)
+	{
+		for (TPair<EMaterialProperty, TArray<FColor>>& PropertyData : BakeOutput.PropertyData)
+		{
+			FMaterialUtilities::OptimizeSampleArray(PropertyData.Value, BakeOutput.PropertySizes[PropertyData.Key]);
+		}
+
+		// Optimized outputs are smaller, uniform properties are down to a single pixel
+		if (!BakeCacheKeyToPut.IsEmpty())
+		{
+			FUnrealToUnityExporterBakeCache::Put(BakeCacheKeyToPut, MaterialBake.MaterialData, BakeOutput);
+		}
+
+		FUnrealToUnityExporterMaterialData& MaterialData = MaterialBake.BakedMaterialData;
+		const FString MaterialName = GetBakedMaterialName(MaterialData.OriginalMaterialName);
+
+		MaterialData.BakedMaterialInterface = FMaterialUtilities::CreateProxyMaterialAndTextures(BakedMaterialsPackage, MaterialName, BakeOutput, MaterialBake.MeshData, MaterialBake.MaterialData, MaterialOptions);
+		OriginalPathsToMaterialData.Add(MaterialData.OriginalMaterialName, MaterialData);
+	};
+
+	// Bakes of earlier sessions or other machines are fetched from the derived data cache, only the rest is rendered
+	TArray<FString> BakeCacheKeys;
+	BakeCacheKeys.SetNum(MaterialBakes.Num());
+	TArray<int32> BakeIndicesToRender;
+
+	for (int32 BakeIndex = 0; BakeIndex < MaterialBakes.Num(); BakeIndex++)
+	{
+		FMaterialBake& MaterialBake = *MaterialBakes[BakeIndex];
+
+		if (ExportSettings.bUseBakeCache)
+		{
+			BakeCacheKeys[BakeIndex] = FUnrealToUnityExporterBakeCache::GetKeyPrefix(ExportCache.ComputeSourceHash(MaterialBake.MaterialData.Material->GetPackage()->GetFName()), MaterialBake.MeshData);
+		}
+
+		const FString OriginalMaterialPath = MaterialBake.BakedMaterialData.OriginalMaterialName.ToString();
+		FScopedDurationTimer Timer(Report.FindOrAddAsset(OriginalMaterialPath, TEXT("Material")).BakeSeconds);
+		FBakeOutput BakeOutput;
+
+		if (!BakeCacheKeys[BakeIndex].IsEmpty() && FUnrealToUnityExporterBakeCache::Get(BakeCacheKeys[BakeIndex], MaterialBake.MaterialData, BakeOutput))
+		{
+			CreateBakedMaterial(MaterialBake, BakeOutput, FString());
+			Report.Data.CachedBakeCount++;
+		}
+		else
+		{
+			BakeIndicesToRender.Add(BakeIndex);
+		}
+	}
+
+	// Small props are dominated by the per call render target setup and readback sync, so several materials share one call
+	const int32 MaterialsPerBake = FMath::Max(ExportSettings.MaterialsPerBake, 1);
+
+	for (int32 RenderStartIndex = 0; RenderStartIndex < BakeIndicesToRender.Num(); RenderStartIndex += MaterialsPerBake)
+	{
+		const TConstArrayView<int32> BakeIndices = MakeArrayView(BakeIndicesToRender).Slice(RenderStartIndex, FMath::Min(MaterialsPerBake, BakeIndicesToRender.Num() - RenderStartIndex));
+
+		TArray<FMaterialData*> MaterialDatas;
+		TArray<FMeshData*> MeshDatas;
+
+		for (const int32 BakeIndex : BakeIndices)
+		{
+			MaterialDatas.Add(&MaterialBakes[BakeIndex]->MaterialData);
+			MeshDatas.Add(&MaterialBakes[BakeIndex]->MeshData);
+		}
+
+		TArray<FBakeOutput> BakeOutputs;
+		const double BakeStartSeconds = FPlatformTime::Seconds();
+		{
+			TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_BakeMaterials);
+			MaterialBakingModule.BakeMaterials(MaterialDatas, MeshDatas, BakeOutputs);
+		}
+
+		// Materials of one call can't be timed separately, each gets an equal share
+		const double BakeSecondsPerMaterial = (FPlatformTime::Seconds() - BakeStartSeconds) / BakeIndices.Num();
+
+		for (int32 OutputIndex = 0; OutputIndex < BakeOutputs.Num() && OutputIndex < BakeIndices.Num(); OutputIndex++)
+		{
+			const int32 BakeIndex = BakeIndices[OutputIndex];
+			FMaterialBake& MaterialBake = *MaterialBakes[BakeIndex];
+			const FString OriginalMaterialPath = MaterialBake.BakedMaterialData.OriginalMaterialName.ToString();
+			TRACE_CPUPROFILER_EVENT_SCOPE_TEXT(*OriginalMaterialPath);
+			FUnrealToUnityExporterExportReportAsset& ReportAsset = Report.FindOrAddAsset(OriginalMaterialPath, TEXT("Material"));
+			ReportAsset.BakeSeconds += BakeSecondsPerMaterial;
+			FScopedDurationTimer Timer(ReportAsset.BakeSeconds);
+
+			CreateBakedMaterial(MaterialBake, BakeOutputs[OutputIndex], BakeCacheKeys[BakeIndex]);
+
+			// Frees the chunk's pixels as soon as its proxy textures hold them
+			BakeOutputs[OutputIndex] = FBakeOutput();
 		}
+
+		if (BakeOutputs.Num() != BakeIndices.Num())
+		{
+			UE_LOG(LogTemp, Error, TEXT("Material baking returned %d of %d outputs"), BakeOutputs.Num(), BakeIndices.Num());
+		}
+	}
+
+	// Source assets are never modified, the baked materials are assigned to transient copies which are exported instead
+	for (int32 MeshIndex = 0; MeshIndex < StaticMeshes.Num(); MeshIndex++)
+	{
+		const UStaticMesh* SourceStaticMesh = StaticMeshes[MeshIndex];
+		const FString SourceStaticMeshPath = SourceStaticMesh->GetPathName();
+		TRACE_CPUPROFILER_EVENT_SCOPE_TEXT(*SourceStaticMeshPath);
+		FScopedDurationTimer Timer(Report.FindOrAddAsset(SourceStaticMeshPath, TEXT("Mesh")).BakeSeconds);
+
+		// Every copy gets its own package so it keeps the source name, which ends up in the FBX file
+		UPackage* BakedStaticMeshPackage = CreatePackage(*(BakedMaterialsPackage->GetName() + SourceStaticMesh->GetPackage()->GetName()));
+		BakedStaticMeshPackage->SetFlags(RF_Transient);
+
+		UStaticMesh* StaticMesh = DuplicateObject(SourceStaticMesh, BakedStaticMeshPackage, SourceStaticMesh->GetFName());
+		StaticMesh->ClearFlags(RF_Public | RF_Standalone);
+		StaticMesh->SetFlags(RF_Transient);
+
+		// Render data isn't duplicated, building it hits the derived data cache filled by the source mesh
+		if (!StaticMesh->GetRenderData() || !StaticMesh->GetRenderData()->IsInitialized())
+		{
+			StaticMesh->Build(true /*bInSilent*/);
+		}
+
+		TArray<FStaticMaterial> StaticMaterials = StaticMesh->GetStaticMaterials();
+		bool bIsBaked = true;
+
+		for (const auto& [MaterialIndex, BakeIndex] : MaterialIndicesToBakeIndicesPerMesh[MeshIndex])
+		{
+			StaticMaterials[MaterialIndex].MaterialInterface = MaterialBakes[BakeIndex]->BakedMaterialData.BakedMaterialInterface;
+			bIsBaked &= StaticMaterials[MaterialIndex].MaterialInterface != nullptr;
+		}
+
+		if (!bIsBaked)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Mesh has materials which couldn't be baked: %s"), *SourceStaticMeshPath);
+		}
+
+		for (const auto& [MaterialIndex, BakedMaterial] : MaterialIndicesToBakedMaterialsPerMesh[MeshIndex])
+		{
+			StaticMaterials[MaterialIndex].MaterialInterface = BakedMaterial;
+		}
+
+		StaticMesh->SetStaticMaterials(StaticMaterials);
+		OutBakedStaticMeshes.Add(StaticMesh);
+		OutAreMeshesBaked.Add(bIsBaked);
 	}
 }
 
-void FUnrealToUnityExporterModule::ExportMeshes(const TArrayView<UStaticMesh*> StaticMeshes, const FString& ExportDirectory, FUnrealToUnityExporterImportDescriptor& ImportDescriptor, const FExportSettings& ExportSettings)
+bool FUnrealToUnityExporterModule::ExportMeshes(const TArrayView<UStaticMesh*> StaticMeshes, const TArrayView<UStaticMesh*> BakedStaticMeshes, const FString& ExportDirectory, TArray<FUnrealToUnityExporterMeshDescriptor>& OutMeshDescriptors, TArray<bool>& OutAreMeshesExported, FUnrealToUnityExporterFbxWorkers& FbxWorkers, const FExportSettings& ExportSettings, FUnrealToUnityExporterExportReport& Report)
 {
-	const FAssetToolsModule& AssetToolsModule = FModuleManager::GetModuleChecked<FAssetToolsModule>("AssetTools");
-	TArray<UObject*> Objects;
-	Algo::Transform(StaticMeshes, Objects, [] (UStaticMesh* StaticMesh)
-	{
-		return StaticMesh;
-	});
+	TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_ExportMeshes);
+	FScopedDurationTimer ExportTimer(Report.Data.MeshExportSeconds);
 
 	const FString ExportFolder = TEXT("Models");
-	const FString MeshExportDirectory = ExportDirectory / ExportFolder;
-	
-	AssetToolsModule.Get().ExportAssets(Objects, MeshExportDirectory);
 
-	for (const UStaticMesh* StaticMesh : StaticMeshes)
+	auto GetMeshPath = [&ExportFolder] (const UStaticMesh& StaticMesh)
+	{
+		return ExportFolder / StaticMesh.GetPackage()->GetPathName() + TEXT(".fbx");
+	};
+
+	// Workers load meshes from disk, unsaved and transient ones can only be exported here
+	TArray<FUnrealToUnityExporterFbxWorkerMesh> WorkerMeshes;
+	TArray<int32> WorkerMeshIndices;
+
+	for (int32 MeshIndex = 0; ExportSettings.MeshExportProcesses > 1 && MeshIndex < StaticMeshes.Num(); MeshIndex++)
+	{
+		const UPackage* Package = StaticMeshes[MeshIndex]->GetPackage();
+
+		if (Package->HasAnyFlags(RF_Transient) || Package->IsDirty() || !FPackageName::DoesPackageExist(Package->GetName()))
+		{
+			continue;
+		}
+
+		FUnrealToUnityExporterFbxWorkerMesh& WorkerMesh = WorkerMeshes.AddDefaulted_GetRef();
+		WorkerMesh.SourceMeshPath = StaticMeshes[MeshIndex]->GetPathName();
+		WorkerMesh.bExportLods = ExportSettings.LodStrategy != EExportLodStrategy::Lod0Only;
+		WorkerMesh.Filename = FPaths::ConvertRelativePathToFull(ExportDirectory / GetMeshPath(*StaticMeshes[MeshIndex]));
+
+		for (const FStaticMaterial& StaticMaterial : BakedStaticMeshes[MeshIndex]->GetStaticMaterials())
+		{
+			WorkerMesh.MaterialNames.Add(StaticMaterial.MaterialInterface ? StaticMaterial.MaterialInterface->GetName() : FString());
+		}
+
+		WorkerMeshIndices.Add(MeshIndex);
+	}
+
+	TArray<FUnrealToUnityExporterFbxWorkerResult> WorkerResults;
+	FbxWorkers.Export(WorkerMeshes, WorkerResults);
+
+	TArray<bool> AreExportedByWorkers;
+	AreExportedByWorkers.Init(false, StaticMeshes.Num());
+
+	for (int32 WorkerMeshIndex = 0; WorkerMeshIndex < WorkerResults.Num(); WorkerMeshIndex++)
+	{
+		const FUnrealToUnityExporterFbxWorkerResult& WorkerResult = WorkerResults[WorkerMeshIndex];
+
+		if (WorkerResult.bIsExported)
+		{
+			const int32 MeshIndex = WorkerMeshIndices[WorkerMeshIndex];
+			AreExportedByWorkers[MeshIndex] = true;
+
+			FUnrealToUnityExporterExportReportAsset& ReportAsset = Report.FindOrAddAsset(StaticMeshes[MeshIndex]->GetPathName(), TEXT("Mesh"));
+			ReportAsset.ExportSeconds += WorkerResult.ExportSeconds;
+			ReportAsset.BytesWritten = WorkerResult.BytesWritten;
+			Report.Data.BytesWritten += WorkerResult.BytesWritten;
+		}
+	}
+
+	UFbxExportOption* FbxExportOption = NewObject<UFbxExportOption>();
+	FbxExportOption->LoadOptions();
+	FbxExportOption->LevelOfDetail = ExportSettings.LodStrategy != EExportLodStrategy::Lod0Only;
+
+	bool bIsSucceeded = true;
+
+	for (int32 MeshIndex = 0; MeshIndex < StaticMeshes.Num(); MeshIndex++)
 	{
+		const UStaticMesh* StaticMesh = StaticMeshes[MeshIndex];
+
 		FUnrealToUnityExporterMeshDescriptor MeshDescriptor;
-		MeshDescriptor.MeshPath = ExportFolder / StaticMesh->GetPackage()->GetPathName() + TEXT(".fbx");
+		MeshDescriptor.MeshPath = GetMeshPath(*StaticMesh);
 		MeshDescriptor.bEnableReadWrite = ExportSettings.bEnableReadWrite;
-		ImportDescriptor.MeshDescriptors.Add(MoveTemp(MeshDescriptor));
+
+		if (AreExportedByWorkers[MeshIndex])
+		{
+			OutMeshDescriptors.Add(MoveTemp(MeshDescriptor));
+			OutAreMeshesExported.Add(true);
+			continue;
+		}
+
+		const FString StaticMeshPath = StaticMesh->GetPathName();
+		TRACE_CPUPROFILER_EVENT_SCOPE_TEXT(*StaticMeshPath);
+		FUnrealToUnityExporterExportReportAsset& ReportAsset = Report.FindOrAddAsset(StaticMeshPath, TEXT("Mesh"));
+		FScopedDurationTimer Timer(ReportAsset.ExportSeconds);
+
+		// Automated tasks never open the FBX options dialog, so exporting works without any UI
+		UAssetExportTask* ExportTask = NewObject<UAssetExportTask>();
+		ExportTask->Object = BakedStaticMeshes[MeshIndex];
+		ExportTask->Filename = ExportDirectory / MeshDescriptor.MeshPath;
+		ExportTask->bSelected = false;
+		ExportTask->bReplaceIdentical = true;
+		ExportTask->bPrompt = false;
+		ExportTask->bAutomated = true;
+		ExportTask->Options = FbxExportOption;
+
+		const bool bIsExported = UExporter::RunAssetExportTask(ExportTask);
+
+		if (bIsExported)
+		{
+			ReportAsset.BytesWritten = FMath::Max<int64>(IFileManager::Get().FileSize(*ExportTask->Filename), 0);
+			Report.Data.BytesWritten += ReportAsset.BytesWritten;
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("Mesh couldn't be exported: %s"), *StaticMeshPath);
+			bIsSucceeded = false;
+		}
+		
+		OutMeshDescriptors.Add(MoveTemp(MeshDescriptor));
+		OutAreMeshesExported.Add(bIsExported);
 	}
+
+	return bIsSucceeded;
 }
 
-void FUnrealToUnityExporterModule::ExportMaterials(const TMap<FName, FUnrealToUnityExporterMaterialData>& OriginalPathsToMaterialData, const FString& ExportDirectory, FUnrealToUnityExporterImportDescriptor& ImportDescriptor)
+void FUnrealToUnityExporterModule::ExportMaterials(TMap<FName, FUnrealToUnityExporterMaterialData>& OriginalPathsToMaterialData, FUnrealToUnityExporterDescriptorWriter& DescriptorWriter, TMap<FName, FUnrealToUnityExporterMaterialDescriptor>& OriginalPathsToMaterialDescriptors, FUnrealToUnityExporterTextureWriter& TextureWriter, const FExportSettings& ExportSettings, FUnrealToUnityExporterExportReport& Report)
 {
-	for (const auto& [OriginalPath, MaterialData] : OriginalPathsToMaterialData)
+	TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_ExportMaterials);
+
+	for (auto& [OriginalPath, MaterialData] : OriginalPathsToMaterialData)
 	{
+		// Exported after their equivalent
+		if (MaterialData.bIsExported || !MaterialData.CanonicalMaterialName.IsNone())
+		{
+			continue;
+		}
+
+		MaterialData.bIsExported = true;
+
+		const FString OriginalMaterialPath = OriginalPath.ToString();
+		TRACE_CPUPROFILER_EVENT_SCOPE_TEXT(*OriginalMaterialPath);
+		FUnrealToUnityExporterExportReportAsset& ReportAsset = Report.FindOrAddAsset(OriginalMaterialPath, TEXT("Material"));
+		Report.Data.ExportedMaterialCount++;
+		
 		FUnrealToUnityExporterMaterialDescriptor MaterialDescriptor;
 		const FString OriginalPathStr = FPaths::GetPath(OriginalPath.ToString()) / MaterialData.BakedMaterialInterface->GetName();
 		MaterialDescriptor.MaterialPath = TEXT("Materials") / OriginalPathStr;
 		MaterialDescriptor.BlendMode = MaterialData.OriginalBlendMode;
-		const FString ExportFolder = TEXT("Textures");
-		ExportTextures(*MaterialData.BakedMaterialInterface, ExportDirectory, ExportFolder / OriginalPathStr, MaterialDescriptor);
 
-		ImportDescriptor.MaterialDescriptors.Add(MoveTemp(MaterialDescriptor));
+		if (MaterialData.PassThroughMaterialInterface)
+		{
+			ExportPassThroughTextures(*MaterialData.PassThroughMaterialInterface, MaterialDescriptor, TextureWriter, ExportSettings, Report, ReportAsset);
+		}
+		else
+		{
+			ExportTextures(*MaterialData.BakedMaterialInterface, MaterialDescriptor, TextureWriter, ExportSettings, Report, ReportAsset);
+		}
+
+		DescriptorWriter.AddMaterial(MaterialDescriptor);
+		OriginalPathsToMaterialDescriptors.Add(OriginalPath, MoveTemp(MaterialDescriptor));
+	}
+
+	// Merged materials point at the files of their equivalent, only the descriptor is their own
+	for (auto& [OriginalPath, MaterialData] : OriginalPathsToMaterialData)
+	{
+		if (MaterialData.bIsExported || MaterialData.CanonicalMaterialName.IsNone())
+		{
+			continue;
+		}
+
+		const FUnrealToUnityExporterMaterialDescriptor* CanonicalMaterialDescriptor = OriginalPathsToMaterialDescriptors.Find(MaterialData.CanonicalMaterialName);
+
+		// Its bake failed, the meshes using it were left out as well
+		if (!CanonicalMaterialDescriptor)
+		{
+			continue;
+		}
+
+		MaterialData.bIsExported = true;
+		Report.Data.MergedMaterialCount++;
+
+		// Adding can reallocate the map, copied before it
+		FUnrealToUnityExporterMaterialDescriptor MaterialDescriptor = *CanonicalMaterialDescriptor;
+		OriginalPathsToMaterialDescriptors.Add(OriginalPath, MoveTemp(MaterialDescriptor));
 	}
 }
 
-void FUnrealToUnityExporterModule::ExportTextures(const UMaterialInterface& MaterialInterface, const FString& ExportDirectory, const FString& ExportFolder, FUnrealToUnityExporterMaterialDescriptor& MaterialDescriptor)
+void FUnrealToUnityExporterModule::ExportTextures(const UMaterialInterface& MaterialInterface, FUnrealToUnityExporterMaterialDescriptor& MaterialDescriptor, FUnrealToUnityExporterTextureWriter& TextureWriter, const FExportSettings& ExportSettings, FUnrealToUnityExporterExportReport& Report, FUnrealToUnityExporterExportReportAsset& ReportAsset)
 {
 	TArray<FGuid> DummyParameterIds;
 	
@@ -242,8 +1538,6 @@ void FUnrealToUnityExporterModule::ExportTextures(const UMaterialInterface& Mate
 	TArray<FMaterialParameterInfo> ScalarParameterInfos;
 	MaterialInterface.GetAllScalarParameterInfo(ScalarParameterInfos, DummyParameterIds);
 	
-	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-
 	auto FindMaterialParameterInfo = [] (const TArray<FMaterialParameterInfo>& MaterialParameterInfos, const FString& Name)
 	{
 		return MaterialParameterInfos.FindByPredicate([&Name] (const FMaterialParameterInfo& MaterialParameterInfo)
@@ -254,6 +1548,9 @@ void FUnrealToUnityExporterModule::ExportTextures(const UMaterialInterface& Mate
 	
 	const FString SwitchParameterPrefix = TEXT("Use");
 	const FString TextureParameterSuffix = TEXT("Texture");
+
+	// Images of mask map properties are only written once every property of the material is known
+	TMap<FString, FImage> MaskMapImages;
 	
 	for (const FMaterialParameterInfo& TextureParameterInfo : TextureParameterInfos)
 	{
@@ -281,18 +1578,17 @@ void FUnrealToUnityExporterModule::ExportTextures(const UMaterialInterface& Mate
 				if (UTexture2D* Texture2D = Cast<UTexture2D>(Texture))
 				{
 					FImage OutImage;
-					Texture2D->Source.GetMipImage(OutImage, 0);
-					const FString TexturePath = ExportFolder / TextureParameterInfo.Name.ToString() + TEXT(".png");
-					const FString ExportPath = ExportDirectory / TexturePath;
-				
-					if (FPaths::FileExists(ExportPath))
 					{
-						PlatformFile.DeleteFile(*ExportPath);
+						TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_FetchMip);
+						FScopedDurationTimer MipFetchTimer(Report.Data.MipFetchSeconds);
+						FScopedDurationTimer AssetTimer(ReportAsset.ExportSeconds);
+						Texture2D->Source.GetMipImage(OutImage, 0);
 					}
-				
-					FImageUtils::SaveImageByExtension(*ExportPath, OutImage);
 
-					TextureDescriptor.TexturePath = TexturePath;
+					const FString ConstParameterName = TextureDescriptor.ParameterName + TEXT("Const");
+					const bool bHasVectorConst = FindMaterialParameterInfo(VectorParameterInfos, ConstParameterName) != nullptr;
+					const bool bHasScalarConst = !bHasVectorConst && FindMaterialParameterInfo(ScalarParameterInfos, ConstParameterName) != nullptr;
+					AddTextureImage(MoveTemp(OutImage), bHasVectorConst, bHasScalarConst, TextureDescriptor, MaskMapImages, TextureWriter, ExportSettings, ReportAsset);
 				}
 			}
 		}
@@ -343,66 +1639,71 @@ void FUnrealToUnityExporterModule::ExportTextures(const UMaterialInterface& Mate
 			MaterialDescriptor.TextureDescriptors.Add(MoveTemp(TextureDescriptor));
 		}
 	}
+
+	WriteMaskMap(MaskMapImages, MaterialDescriptor, TextureWriter, ExportSettings, ReportAsset);
 }
 
-void FUnrealToUnityExporterModule::RevertChanges(const TArrayView<UStaticMesh*> StaticMeshes, const TArrayView<UMaterialInterface*> MaterialInterfaces)
+void FUnrealToUnityExporterModule::ExportPassThroughTextures(UMaterialInterface& MaterialInterface, FUnrealToUnityExporterMaterialDescriptor& MaterialDescriptor, FUnrealToUnityExporterTextureWriter& TextureWriter, const FExportSettings& ExportSettings, FUnrealToUnityExporterExportReport& Report, FUnrealToUnityExporterExportReportAsset& ReportAsset)
 {
-	GEditor->UndoTransaction(false /*bCanRedo*/);
+	TMap<FString, FImage> MaskMapImages;
 
-	TArray<UPackage*> PackagesToReload;
-	Algo::Transform(StaticMeshes, PackagesToReload, [] (const UStaticMesh* StaticMesh)
+	for (const FPassThroughProperty& PassThroughProperty : PassThroughProperties)
 	{
-		return StaticMesh->GetPackage();
-	});
-	
-	UPackageTools::ReloadPackages(PackagesToReload);
-}
+		FPassThroughInput Input;
 
-FString FUnrealToUnityExporterModule::SaveImportDescriptor(const FUnrealToUnityExporterImportDescriptor& ImportDescriptor, const FString& ExportDirectory)
-{
-	TSharedRef<FJsonObject> JsonObject = FJsonObjectConverter::UStructToJsonObject(ImportDescriptor).ToSharedRef();
-	FString JsonString;
-	const TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&JsonString);
-	FJsonSerializer::Serialize(JsonObject, JsonWriter, true);
-	const FString SavePath = ExportDirectory / TEXT("ImportDescriptor.txt");
-	FFileHelper::SaveStringToFile(JsonString, *SavePath);
-
-	return SavePath;
-}
+		if (!GetPassThroughInput(MaterialInterface, PassThroughProperty, Input))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Material input isn't a pass-through anymore: %s %s"), *MaterialInterface.GetPathName(), PassThroughProperty.ParameterName);
+			continue;
+		}
 
-void FUnrealToUnityExporterModule::SendUnityImportMessage(const FString& ImportDescriptorSavePath)
-{
-	const FIPv4Endpoint ClientEndpoint(FIPv4Address(127, 0, 0, 1), 55720);
-	
-	FSocket* Socket = FTcpSocketBuilder(TEXT("UnrealToUnityMeshExporterClient")).AsBlocking();
+		FUnrealToUnityExporterTextureDescriptor TextureDescriptor;
+		TextureDescriptor.ParameterName = PassThroughProperty.ParameterName;
 
-	if (!Socket->Connect(ClientEndpoint.ToInternetAddr().Get()))
-	{
-		UE_LOG(LogTemp, Error, TEXT("Socket couldn't connect"));
-		return;
-	}
-	
-	FString Message = TEXT("unrealToUnityImporter?");
+		if (Input.Texture)
+		{
+			FImage OutImage;
+			{
+				TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_FetchMip);
+				FScopedDurationTimer MipFetchTimer(Report.Data.MipFetchSeconds);
+				FScopedDurationTimer AssetTimer(ReportAsset.ExportSeconds);
+				Input.Texture->Source.GetMipImage(OutImage, 0);
 
-	if (!ImportDescriptorSavePath.IsEmpty())
-	{
-		Message += TEXT("ImportDescriptorPath=");
-		Message += ImportDescriptorSavePath;
-	}
+				// Same size limit as baked textures
+				const int32 LargestSize = FMath::Max(OutImage.SizeX, OutImage.SizeY);
 
-	int32 Utf8Length = FTCHARToUTF8_Convert::ConvertedLength(*Message, Message.Len());
-	TArray<uint8> Buffer;
-	Buffer.SetNumUninitialized(Utf8Length);
-	FTCHARToUTF8_Convert::Convert((UTF8CHAR*)Buffer.GetData(), Buffer.Num(), *Message, Message.Len());
-	
-	int32 MessageBufferSize;
-	Socket->Send(Buffer.GetData(), Buffer.Num(), MessageBufferSize);
+				if (LargestSize > ExportSettings.TextureSize)
+				{
+					const float Scale = static_cast<float>(ExportSettings.TextureSize) / LargestSize;
+					FImage ResizedImage;
+					OutImage.ResizeTo(ResizedImage, FMath::Max(FMath::RoundToInt(OutImage.SizeX * Scale), 1), FMath::Max(FMath::RoundToInt(OutImage.SizeY * Scale), 1), OutImage.Format, OutImage.GammaSpace);
+					OutImage = MoveTemp(ResizedImage);
+				}
+
+				if (Input.Channel != 0)
+				{
+					OutImage = ExtractChannel(OutImage, Input.Channel);
+				}
+			}
+
+			TextureDescriptor.bUseTexture = true;
+			AddTextureImage(MoveTemp(OutImage), PassThroughProperty.bHasConst && PassThroughProperty.bIsColor, PassThroughProperty.bHasConst && !PassThroughProperty.bIsColor, TextureDescriptor, MaskMapImages, TextureWriter, ExportSettings, ReportAsset);
+		}
+		else if (PassThroughProperty.bHasConst)
+		{
+			TextureDescriptor.bUseColor = PassThroughProperty.bIsColor;
+			TextureDescriptor.bUseScalar = !PassThroughProperty.bIsColor;
+			TextureDescriptor.Color = Input.Constant;
+			TextureDescriptor.Scalar = Input.Constant.R;
+		}
 
-	Socket->Shutdown(ESocketShutdownMode::ReadWrite);
-	Socket->Close();
+		if (TextureDescriptor.bUseTexture || TextureDescriptor.bUseColor || TextureDescriptor.bUseScalar)
+		{
+			MaterialDescriptor.TextureDescriptors.Add(MoveTemp(TextureDescriptor));
+		}
+	}
 
-	ISocketSubsystem& SocketSubsystem = *(ISocketSubsystem::Get());
-	SocketSubsystem.DestroySocket(Socket);
+	WriteMaskMap(MaskMapImages, MaterialDescriptor, TextureWriter, ExportSettings, ReportAsset);
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,104 @@
+﻿#include "UnrealToUnityExporterAssetLoader.h"
+
+#include "Serialization/AsyncLoadingFlush.h"
+#include "UObject/UObjectGlobals.h"
+
+FUnrealToUnityExporterAssetLoader::FUnrealToUnityExporterAssetLoader(const TArray<FAssetData>& InAssets, int32 InMaxLoadedAssets)
+	: Assets(InAssets)
+	, MaxLoadedAssets(FMath::Max(InMaxLoadedAssets, 1))
+{
+	LoadedAssets.SetNum(Assets.Num());
+	RequestIds.Init(INDEX_NONE, Assets.Num());
+	RequestLoads();
+}
+
+FUnrealToUnityExporterAssetLoader::~FUnrealToUnityExporterAssetLoader()
+{
+	// Completion callbacks reference this loader
+	for (const int32 RequestId : RequestIds)
+	{
+		if (RequestId != INDEX_NONE)
+		{
+			FlushAsyncLoading(RequestId);
+		}
+	}
+}
+
+TArray<UObject*> FUnrealToUnityExporterAssetLoader::LoadBatch(int32 StartIndex, int32 Count)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_LoadBatch);
+
+	// Batches larger than the window still have to be loaded completely
+	RequestLoads(StartIndex + Count);
+
+	TArray<UObject*> Batch;
+	Batch.Reserve(Count);
+
+	for (int32 Index = StartIndex; Index < StartIndex + Count; Index++)
+	{
+		if (RequestIds[Index] != INDEX_NONE)
+		{
+			FlushAsyncLoading(RequestIds[Index]);
+		}
+
+		if (UObject* Asset = LoadedAssets[Index].Get())
+		{
+			Batch.Add(Asset);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("Asset couldn't be loaded: %s"), *Assets[Index].GetObjectPathString());
+		}
+	}
+
+	return Batch;
+}
+
+void FUnrealToUnityExporterAssetLoader::ProcessLoads(double TimeLimitSeconds)
+{
+	// The loading thread advances them by itself
+	if (IsAsyncLoadingMultithreaded() || !IsAsyncLoading())
+	{
+		return;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_ProcessLoads);
+	ProcessAsyncLoading(true /*bUseTimeLimit*/, false /*bUseFullTimeLimit*/, TimeLimitSeconds);
+}
+
+void FUnrealToUnityExporterAssetLoader::ReleaseBatch(int32 StartIndex, int32 Count)
+{
+	for (int32 Index = StartIndex; Index < StartIndex + Count; Index++)
+	{
+		LoadedAssets[Index].Reset();
+	}
+
+	LoadedOrPendingCount = FMath::Max(LoadedOrPendingCount - Count, 0);
+	RequestLoads();
+}
+
+void FUnrealToUnityExporterAssetLoader::RequestLoads(int32 MinEndIndex)
+{
+	for (; NextRequestIndex < Assets.Num() && (LoadedOrPendingCount < MaxLoadedAssets || NextRequestIndex < MinEndIndex); NextRequestIndex++, LoadedOrPendingCount++)
+	{
+		const int32 Index = NextRequestIndex;
+
+		// Assets open in the editor or created in memory are used as they are, unsaved changes included
+		if (UObject* LoadedAsset = Assets[Index].FastGetAsset(false))
+		{
+			LoadedAssets[Index].Reset(LoadedAsset);
+			continue;
+		}
+
+		RequestIds[Index] = LoadPackageAsync(Assets[Index].PackageName.ToString(), FLoadPackageAsyncDelegate::CreateLambda([this, Index] (const FName& PackageName, UPackage* Package, EAsyncLoadingResult::Type Result)
+		{
+			RequestIds[Index] = INDEX_NONE;
+
+			if (Result == EAsyncLoadingResult::Succeeded)
+			{
+				// Only looks the object up, the package is already loaded
+				LoadedAssets[Index].Reset(Assets[Index].FastGetAsset(false));
+			}
+		}));
+	}
+}
@@ -0,0 +1,38 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "UObject/StrongObjectPtr.h"
+
+/**
+ * Loads the exported assets with async package loading, in order and a bounded number of assets ahead of the one
+ * being processed, so reading packages overlaps with baking and exporting the previous ones.
+ * Without the async loading thread, which is off in the editor by default, loads only advance inside ProcessLoads.
+ * Loaded assets are kept alive across garbage collections until their batch is released.
+ */
+class FUnrealToUnityExporterAssetLoader
+{
+public:
+	FUnrealToUnityExporterAssetLoader(const TArray<FAssetData>& InAssets, int32 InMaxLoadedAssets);
+	~FUnrealToUnityExporterAssetLoader();
+
+	/** Blocks until the batch is loaded, assets which couldn't be loaded are left out */
+	TArray<UObject*> LoadBatch(int32 StartIndex, int32 Count);
+
+	/** Advances pending loads for at most TimeLimitSeconds, call it between the steps of the work overlapping the loads */
+	void ProcessLoads(double TimeLimitSeconds = 0.01);
+
+	/** Lets the next garbage collection free the batch and starts loading further assets */
+	void ReleaseBatch(int32 StartIndex, int32 Count);
+
+private:
+	/** Stays within MaxLoadedAssets, except for assets before MinEndIndex */
+	void RequestLoads(int32 MinEndIndex = 0);
+
+	TArray<FAssetData> Assets;
+	TArray<TStrongObjectPtr<UObject>> LoadedAssets;
+	TArray<int32> RequestIds;
+	int32 NextRequestIndex = 0;
+	int32 LoadedOrPendingCount = 0;
+	int32 MaxLoadedAssets;
+};
@@ -0,0 +1,125 @@
+﻿#include "UnrealToUnityExporterAssetSearch.h"
+
+#include "Algo/RemoveIf.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+
+namespace
+{
+	const TArray<FTopLevelAssetPath> SupportedTypes =
+	{
+		FTopLevelAssetPath(TEXT("/Script/Engine.StaticMesh"))
+	};
+}
+
+int32 FUnrealToUnityExporterAssetSearch::FindAssetsByObjectPaths(const TArray<FString>& ObjectPathStrings, TArray<FAssetData>& OutAssets)
+{
+	FARFilter Filter;
+	Filter.bIncludeOnlyOnDiskAssets = true;
+	Filter.ClassPaths = SupportedTypes;
+	
+	Algo::Transform(ObjectPathStrings, Filter.SoftObjectPaths, [] (const FString& ObjectPathString)
+	{
+		return FSoftObjectPath(ObjectPathString);
+	});
+
+	const IAssetRegistry& AssetRegistry = FModuleManager::Get().LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	TArray<FAssetData> Assets;
+	int32 ErrorCount = 0;
+	
+	if (AssetRegistry.GetAssets(Filter, Assets))
+	{
+		TSet<FSoftObjectPath> FoundObjectPaths;
+		FoundObjectPaths.Reserve(Assets.Num());
+
+		for (const FAssetData& AssetData : Assets)
+		{
+			FoundObjectPaths.Add(AssetData.ToSoftObjectPath());
+		}
+
+		for (const FSoftObjectPath& ObjectPath : Filter.SoftObjectPaths)
+		{
+			if (!FoundObjectPaths.Contains(ObjectPath))
+			{
+				ErrorCount++;
+			}
+		}
+
+		OutAssets.Append(MoveTemp(Assets));
+	}
+
+	return ErrorCount;
+}
+
+int32 FUnrealToUnityExporterAssetSearch::FindAssetsInFolders(const TArray<FString>& FolderPaths, const TArray<FString>& ExcludeStrings, const TArray<FString>& ExcludeAssetPaths, TArray<FAssetData>& OutAssets)
+{
+	FARFilter Filter;
+	Filter.bIncludeOnlyOnDiskAssets = true;
+	Filter.bRecursivePaths = true;
+	Filter.ClassPaths = SupportedTypes;
+	
+	Algo::Transform(FolderPaths, Filter.PackagePaths, [] (const FString& FolderPath)
+	{
+		return FName(FolderPath);
+	});
+
+	const IAssetRegistry& AssetRegistry = FModuleManager::Get().LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	TArray<FAssetData> Assets;
+
+	TArray<FAssetData> ExcludeAssets;
+	FARFilter ExcludeAssetsFilter;
+	ExcludeAssetsFilter.bIncludeOnlyOnDiskAssets = true;
+	
+	Algo::Transform(ExcludeAssetPaths, ExcludeAssetsFilter.SoftObjectPaths, [] (const FString& AssetPath)
+	{
+		return FSoftObjectPath(AssetPath);
+	});
+
+	AssetRegistry.GetAssets(ExcludeAssetsFilter, ExcludeAssets);
+
+	int32 ErrorCount = ExcludeAssetPaths.Num() - ExcludeAssets.Num();
+
+	TSet<FSoftObjectPath> ExcludeObjectPaths;
+	ExcludeObjectPaths.Reserve(ExcludeAssets.Num());
+
+	for (const FAssetData& ExcludeAsset : ExcludeAssets)
+	{
+		ExcludeObjectPaths.Add(ExcludeAsset.ToSoftObjectPath());
+	}
+	
+	if (AssetRegistry.GetAssets(Filter, Assets))
+	{
+		// Excluded assets which aren't in the searched folders are reported as errors
+		int32 ExcludedCount = 0;
+
+		Assets.SetNum(Algo::RemoveIf(Assets, [&ExcludeObjectPaths, &ExcludedCount] (const FAssetData& AssetData)
+		{
+			if (ExcludeObjectPaths.Contains(AssetData.ToSoftObjectPath()))
+			{
+				ExcludedCount++;
+				return true;
+			}
+			
+			return false;
+		}));
+
+		ErrorCount += ExcludeObjectPaths.Num() - ExcludedCount;
+
+		Assets.SetNum(Algo::RemoveIf(Assets, [&ExcludeStrings] (const FAssetData& AssetData)
+		{
+			for (const FString& ExcludeString : ExcludeStrings)
+			{
+				if (AssetData.AssetName.ToString().Contains(ExcludeString))
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}));
+		
+		OutAssets.Append(MoveTemp(Assets));
+	}
+
+	return ErrorCount;
+}
@@ -0,0 +1,14 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+
+/** Resolves the asset selection modes of the export settings window, shared with the commandlet */
+struct FUnrealToUnityExporterAssetSearch
+{
+	/** Returns the number of object paths which couldn't be found */
+	static int32 FindAssetsByObjectPaths(const TArray<FString>& ObjectPathStrings, TArray<FAssetData>& OutAssets);
+
+	/** Returns the number of exclude asset paths which couldn't be found */
+	static int32 FindAssetsInFolders(const TArray<FString>& FolderPaths, const TArray<FString>& ExcludeStrings, const TArray<FString>& ExcludeAssetPaths, TArray<FAssetData>& OutAssets);
+};
@@ -0,0 +1,90 @@
+﻿#include "UnrealToUnityExporterBakeCache.h"
+
+#include "DerivedDataCacheInterface.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+FString FUnrealToUnityExporterBakeCache::GetKeyPrefix(const FString& MaterialSourceHash, const FMeshData& MeshData)
+{
+	if (MaterialSourceHash.IsEmpty() || MeshData.MeshDescription)
+	{
+		return FString();
+	}
+
+	// Shaders and the baking module change with the engine
+	const FString KeyString = FString::Printf(TEXT("%s;%s;UV=%d"), *MaterialSourceHash, *FEngineVersion::Current().ToString(), MeshData.TextureCoordinateIndex);
+	return FMD5::HashAnsiString(*KeyString);
+}
+
+bool FUnrealToUnityExporterBakeCache::Get(const FString& KeyPrefix, const FMaterialData& MaterialData, FBakeOutput& OutBakeOutput)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_BakeCacheGet);
+
+	FBakeOutput BakeOutput;
+
+	for (const auto& [Property, Size] : MaterialData.PropertySizes)
+	{
+		TArray<uint8> Data;
+
+		if (!GetDerivedDataCacheRef().GetSynchronous(*GetPropertyKey(KeyPrefix, Property, Size), Data, TEXT("UnrealToUnityExporter")))
+		{
+			return false;
+		}
+
+		FMemoryReader Reader(Data);
+		FIntPoint StoredSize;
+		float EmissiveScale = 1.f;
+		TArray<FColor> Pixels;
+		Reader << StoredSize << EmissiveScale << Pixels;
+
+		if (Reader.IsError() || Pixels.Num() != StoredSize.X * StoredSize.Y)
+		{
+			return false;
+		}
+
+		if (Property == MP_EmissiveColor)
+		{
+			BakeOutput.EmissiveScale = EmissiveScale;
+		}
+
+		BakeOutput.PropertySizes.Add(Property, StoredSize);
+		BakeOutput.PropertyData.Add(Property, MoveTemp(Pixels));
+	}
+
+	OutBakeOutput = MoveTemp(BakeOutput);
+	return true;
+}
+
+void FUnrealToUnityExporterBakeCache::Put(const FString& KeyPrefix, const FMaterialData& MaterialData, const FBakeOutput& BakeOutput)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_BakeCachePut);
+
+	for (const auto& [Property, RequestedSize] : MaterialData.PropertySizes)
+	{
+		const TArray<FColor>* Pixels = BakeOutput.PropertyData.Find(Property);
+		const FIntPoint* Size = BakeOutput.PropertySizes.Find(Property);
+
+		if (!Pixels || !Size)
+		{
+			continue;
+		}
+
+		TArray<uint8> Data;
+		FMemoryWriter Writer(Data);
+		FIntPoint StoredSize = *Size;
+		float EmissiveScale = BakeOutput.EmissiveScale;
+		Writer << StoredSize << EmissiveScale;
+		// Writing only reads the pixels
+		Writer << const_cast<TArray<FColor>&>(*Pixels);
+
+		GetDerivedDataCacheRef().Put(*GetPropertyKey(KeyPrefix, Property, RequestedSize), Data, TEXT("UnrealToUnityExporter"));
+	}
+}
+
+FString FUnrealToUnityExporterBakeCache::GetPropertyKey(const FString& KeyPrefix, EMaterialProperty Property, FIntPoint Size)
+{
+	const FString Suffix = FString::Printf(TEXT("%s_%d_%dx%d"), *KeyPrefix, static_cast<int32>(Property), Size.X, Size.Y);
+	return FDerivedDataCacheInterface::BuildCacheKey(TEXT("UNREALTOUNITYBAKE"), Version, *Suffix);
+}
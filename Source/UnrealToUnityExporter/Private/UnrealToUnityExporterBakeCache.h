@@ -0,0 +1,30 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "MaterialBakingStructures.h"
+
+/**
+ * Keeps baked material pixels in the derived data cache, so exports in later sessions and on other machines sharing the cache
+ * fetch them instead of rendering the material again. Every baked property is stored on its own, keyed by the saved state of
+ * the material and everything it depends on, the engine version, the property and its size.
+ *
+ * Bakes rendered against mesh data depend on the mesh as well and are never cached.
+ */
+class FUnrealToUnityExporterBakeCache
+{
+public:
+	/** Empty when the bake can't be cached, e.g. because the material or one of its dependencies isn't saved */
+	static FString GetKeyPrefix(const FString& MaterialSourceHash, const FMeshData& MeshData);
+
+	/** Only succeeds if every property of the material data is cached */
+	static bool Get(const FString& KeyPrefix, const FMaterialData& MaterialData, FBakeOutput& OutBakeOutput);
+
+	/** Works on optimized outputs too, entries are keyed by the requested property size */
+	static void Put(const FString& KeyPrefix, const FMaterialData& MaterialData, const FBakeOutput& BakeOutput);
+
+private:
+	static FString GetPropertyKey(const FString& KeyPrefix, EMaterialProperty Property, FIntPoint Size);
+
+	/** Change to invalidate everything stored so far, e.g. when the format or the bake itself changes */
+	static inline const TCHAR* Version = TEXT("6B7A35C2A6F44D0B9E6E0D4F3E1A9C21");
+};
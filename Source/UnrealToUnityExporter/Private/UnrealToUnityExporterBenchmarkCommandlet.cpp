@@ -0,0 +1,354 @@
+﻿#include "UnrealToUnityExporterBenchmarkCommandlet.h"
+
+#include "JsonObjectConverter.h"
+#include "SExportSettingsWindow.h"
+#include "StaticMeshAttributes.h"
+#include "UnrealToUnityExporter.h"
+#include "UnrealToUnityExporterImportListener.h"
+#include "UnrealToUnityExporterImportNotifier.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialInstanceConstant.h"
+#include "Misc/FileHelper.h"
+
+namespace
+{
+	struct FBenchmarkSettings
+	{
+		int32 LodCount = 1;
+		int32 SectionCount = 2;
+		int32 MaterialInstanceCount = 8;
+		int32 Resolution = 8;
+	};
+
+	const TCHAR* BenchmarkPackageRoot = TEXT("/Temp/UnrealToUnityExporterBenchmark");
+
+	FMeshDescription CreateMeshDescription(const FBenchmarkSettings& BenchmarkSettings)
+	{
+		FMeshDescription MeshDescription;
+		FStaticMeshAttributes Attributes(MeshDescription);
+		Attributes.Register();
+
+		TVertexAttributesRef<FVector3f> VertexPositions = Attributes.GetVertexPositions();
+		TVertexInstanceAttributesRef<FVector3f> VertexInstanceNormals = Attributes.GetVertexInstanceNormals();
+		TVertexInstanceAttributesRef<FVector2f> VertexInstanceUVs = Attributes.GetVertexInstanceUVs();
+		TPolygonGroupAttributesRef<FName> PolygonGroupMaterialSlotNames = Attributes.GetPolygonGroupMaterialSlotNames();
+
+		const int32 Resolution = BenchmarkSettings.Resolution;
+
+		// Every section is a grid of quads next to the previous one
+		for (int32 SectionIndex = 0; SectionIndex < BenchmarkSettings.SectionCount; SectionIndex++)
+		{
+			const FPolygonGroupID PolygonGroupID = MeshDescription.CreatePolygonGroup();
+			PolygonGroupMaterialSlotNames[PolygonGroupID] = *FString::Printf(TEXT("Section%d"), SectionIndex);
+
+			TArray<FVertexID> VertexIDs;
+
+			for (int32 Y = 0; Y <= Resolution; Y++)
+			{
+				for (int32 X = 0; X <= Resolution; X++)
+				{
+					const FVertexID VertexID = MeshDescription.CreateVertex();
+					VertexPositions[VertexID] = FVector3f(SectionIndex * 100.f + X * 100.f / Resolution, Y * 100.f / Resolution, 0.f);
+					VertexIDs.Add(VertexID);
+				}
+			}
+
+			for (int32 Y = 0; Y < Resolution; Y++)
+			{
+				for (int32 X = 0; X < Resolution; X++)
+				{
+					const int32 CornerIndices[4] = { Y * (Resolution + 1) + X, (Y + 1) * (Resolution + 1) + X, (Y + 1) * (Resolution + 1) + X + 1, Y * (Resolution + 1) + X + 1 };
+					TArray<FVertexInstanceID> VertexInstanceIDs;
+
+					for (const int32 CornerIndex : CornerIndices)
+					{
+						const FVertexInstanceID VertexInstanceID = MeshDescription.CreateVertexInstance(VertexIDs[CornerIndex]);
+						VertexInstanceNormals[VertexInstanceID] = FVector3f::UpVector;
+						VertexInstanceUVs.Set(VertexInstanceID, 0, FVector2f(CornerIndex % (Resolution + 1), CornerIndex / (Resolution + 1)) / Resolution);
+						VertexInstanceIDs.Add(VertexInstanceID);
+					}
+
+					MeshDescription.CreatePolygon(PolygonGroupID, VertexInstanceIDs);
+				}
+			}
+		}
+
+		return MeshDescription;
+	}
+
+	TArray<UMaterialInterface*> CreateMaterialInstances(const FBenchmarkSettings& BenchmarkSettings)
+	{
+		TArray<UMaterialInterface*> MaterialInstances;
+		UMaterial* DefaultMaterial = UMaterial::GetDefaultMaterial(MD_Surface);
+
+		// Baked materials are keyed by package, so every instance gets its own
+		for (int32 MaterialIndex = 0; MaterialIndex < FMath::Max(BenchmarkSettings.MaterialInstanceCount, 1); MaterialIndex++)
+		{
+			UPackage* Package = CreatePackage(*FString::Printf(TEXT("%s/Materials/MI_Benchmark_%d"), BenchmarkPackageRoot, MaterialIndex));
+			Package->SetFlags(RF_Transient);
+
+			UMaterialInstanceConstant* MaterialInstance = NewObject<UMaterialInstanceConstant>(Package, *FString::Printf(TEXT("MI_Benchmark_%d"), MaterialIndex), RF_Public | RF_Standalone | RF_Transient);
+			MaterialInstance->SetParentEditorOnly(DefaultMaterial);
+			MaterialInstance->PostEditChange();
+			MaterialInstances.Add(MaterialInstance);
+		}
+
+		return MaterialInstances;
+	}
+
+	TArray<UStaticMesh*> CreateStaticMeshes(int32 MeshCount, const FBenchmarkSettings& BenchmarkSettings, const TArray<UMaterialInterface*>& MaterialInstances)
+	{
+		const FMeshDescription MeshDescription = CreateMeshDescription(BenchmarkSettings);
+
+		TArray<const FMeshDescription*> LodMeshDescriptions;
+		LodMeshDescriptions.Init(&MeshDescription, FMath::Max(BenchmarkSettings.LodCount, 1));
+
+		UStaticMesh::FBuildMeshDescriptionsParams BuildParams;
+		BuildParams.bBuildSimpleCollision = false;
+
+		TArray<UStaticMesh*> StaticMeshes;
+
+		for (int32 MeshIndex = 0; MeshIndex < MeshCount; MeshIndex++)
+		{
+			UPackage* Package = CreatePackage(*FString::Printf(TEXT("%s/Meshes/SM_Benchmark_%d"), BenchmarkPackageRoot, MeshIndex));
+			Package->SetFlags(RF_Transient);
+
+			UStaticMesh* StaticMesh = NewObject<UStaticMesh>(Package, *FString::Printf(TEXT("SM_Benchmark_%d"), MeshIndex), RF_Public | RF_Standalone | RF_Transient);
+
+			for (int32 SectionIndex = 0; SectionIndex < BenchmarkSettings.SectionCount; SectionIndex++)
+			{
+				const FName SlotName = *FString::Printf(TEXT("Section%d"), SectionIndex);
+				UMaterialInterface* MaterialInstance = MaterialInstances[(MeshIndex * BenchmarkSettings.SectionCount + SectionIndex) % MaterialInstances.Num()];
+				StaticMesh->GetStaticMaterials().Add(FStaticMaterial(MaterialInstance, SlotName, SlotName));
+			}
+
+			StaticMesh->BuildFromMeshDescriptions(LodMeshDescriptions, BuildParams);
+			StaticMeshes.Add(StaticMesh);
+		}
+
+		return StaticMeshes;
+	}
+
+	template <typename ObjectType>
+	void DestroyObjects(const TArray<ObjectType*>& Objects)
+	{
+		for (ObjectType* Object : Objects)
+		{
+			Object->ClearFlags(RF_Public | RF_Standalone);
+			Object->MarkAsGarbage();
+		}
+
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	/** Seconds per mesh of every phase, the total included */
+	TMap<FString, double> GetPhaseSecondsPerMesh(const FUnrealToUnityExporterBenchmarkRun& Run)
+	{
+		const FUnrealToUnityExporterExportReportData& Report = Run.Report;
+		// Meshes which failed aren't part of the throughput
+		const double MeshCount = FMath::Max(Report.ExportedMeshCount, 1);
+
+		return {
+			{ TEXT("Total"), Report.TotalSeconds / MeshCount },
+			{ TEXT("Load"), Report.LoadSeconds / MeshCount },
+			{ TEXT("Bake"), Report.BakeSeconds / MeshCount },
+			{ TEXT("MeshExport"), Report.MeshExportSeconds / MeshCount },
+			{ TEXT("MipFetch"), Report.MipFetchSeconds / MeshCount },
+			{ TEXT("Encode"), Report.EncodeSeconds / MeshCount },
+			{ TEXT("Write"), Report.WriteSeconds / MeshCount },
+			{ TEXT("DescriptorSave"), Report.DescriptorSaveSeconds / MeshCount },
+			{ TEXT("Notify"), Report.NotifySeconds / MeshCount },
+		};
+	}
+
+	int32 CompareWithBaseline(const FUnrealToUnityExporterBenchmarkResults& Results, const FUnrealToUnityExporterBenchmarkResults& Baseline, double Tolerance)
+	{
+		// Phases this short are dominated by noise
+		constexpr double MinComparedSeconds = 0.05;
+
+		int32 RegressionCount = 0;
+
+		for (const FUnrealToUnityExporterBenchmarkRun& Run : Results.Runs)
+		{
+			const FUnrealToUnityExporterBenchmarkRun* BaselineRun = Baseline.Runs.FindByPredicate([&Run] (const FUnrealToUnityExporterBenchmarkRun& Candidate)
+			{
+				return Candidate.MeshCount == Run.MeshCount && Candidate.PngCompression == Run.PngCompression;
+			});
+
+			if (!BaselineRun)
+			{
+				continue;
+			}
+
+			const TMap<FString, double> PhaseSeconds = GetPhaseSecondsPerMesh(Run);
+			const TMap<FString, double> BaselinePhaseSeconds = GetPhaseSecondsPerMesh(*BaselineRun);
+
+			for (const auto& [Phase, Seconds] : PhaseSeconds)
+			{
+				const double BaselineSeconds = BaselinePhaseSeconds[Phase];
+
+				if (Seconds * Run.MeshCount >= MinComparedSeconds && Seconds > BaselineSeconds * (1.0 + Tolerance))
+				{
+					UE_LOG(LogTemp, Error, TEXT("%d meshes, %s PNG: %s got slower, %.3f ms per mesh, baseline %.3f ms"), Run.MeshCount, *Run.PngCompression, *Phase, Seconds * 1000.0, BaselineSeconds * 1000.0);
+					RegressionCount++;
+				}
+			}
+		}
+
+		return RegressionCount;
+	}
+}
+
+UUnrealToUnityExporterBenchmarkCommandlet::UUnrealToUnityExporterBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UUnrealToUnityExporterBenchmarkCommandlet::Main(const FString& Params)
+{
+	FBenchmarkSettings BenchmarkSettings;
+	FParse::Value(*Params, TEXT("LODs="), BenchmarkSettings.LodCount);
+	FParse::Value(*Params, TEXT("Sections="), BenchmarkSettings.SectionCount);
+	FParse::Value(*Params, TEXT("MaterialInstances="), BenchmarkSettings.MaterialInstanceCount);
+	FParse::Value(*Params, TEXT("Resolution="), BenchmarkSettings.Resolution);
+	BenchmarkSettings.SectionCount = FMath::Max(BenchmarkSettings.SectionCount, 1);
+	BenchmarkSettings.Resolution = FMath::Max(BenchmarkSettings.Resolution, 1);
+
+	FString CountsString = TEXT("10+100+1000+10000");
+	FParse::Value(*Params, TEXT("Counts="), CountsString, false);
+
+	TArray<FString> CountStrings;
+	CountsString.ParseIntoArray(CountStrings, TEXT("+"));
+
+	FString PngCompressionsString = TEXT("Default+Fast+Small");
+	FParse::Value(*Params, TEXT("PngCompressions="), PngCompressionsString, false);
+
+	TArray<FString> PngCompressionStrings;
+	PngCompressionsString.ParseIntoArray(PngCompressionStrings, TEXT("+"));
+
+	double Tolerance = 0.2;
+	FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+
+	FExportSettings ExportSettings;
+	ExportSettings.TextureSize = 256;
+	ExportSettings.bUseExportCache = false;
+	ExportSettings.bUseBakeCache = false;
+	// The instances only differ by package, merged they would all share a single bake
+	ExportSettings.bMergeEquivalentMaterials = false;
+	ExportSettings.bNotifyUnity = true;
+	FParse::Value(*Params, TEXT("TextureSize="), ExportSettings.TextureSize);
+
+	FUnrealToUnityExporterBenchmarkResults Results;
+	Results.LodCount = BenchmarkSettings.LodCount;
+	Results.SectionCount = BenchmarkSettings.SectionCount;
+	Results.MaterialInstanceCount = BenchmarkSettings.MaterialInstanceCount;
+	Results.TextureSize = ExportSettings.TextureSize;
+
+	const FString BenchmarkDirectory = FPaths::ProjectSavedDir() / TEXT("UnrealToUnityExporterBenchmark");
+
+	// Stands in for Unity so notification costs are part of the measurement
+	FUnrealToUnityExporterImportListener ImportListener(FUnrealToUnityExporterImportNotifier::Port);
+
+	if (!ImportListener.IsListening())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Stand-in importer couldn't listen, notifications aren't measured"));
+	}
+
+	const TArray<UMaterialInterface*> MaterialInstances = CreateMaterialInstances(BenchmarkSettings);
+	int32 ErrorCount = 0;
+
+	for (const FString& CountString : CountStrings)
+	{
+		const int32 MeshCount = FCString::Atoi(*CountString);
+
+		if (MeshCount <= 0)
+		{
+			continue;
+		}
+
+		TArray<UStaticMesh*> StaticMeshes = CreateStaticMeshes(MeshCount, BenchmarkSettings, MaterialInstances);
+
+		ExportSettings.SelectedAssets.Reset();
+		for (UStaticMesh* StaticMesh : StaticMeshes)
+		{
+			ExportSettings.SelectedAssets.Add(MakeShared<FAssetData>(StaticMesh));
+		}
+
+		for (const FString& PngCompressionString : PngCompressionStrings)
+		{
+			LexFromString(ExportSettings.PngCompression, *PngCompressionString);
+			const FString PngCompressionName = LexToString(ExportSettings.PngCompression);
+
+			// Every run starts from an empty directory so nothing is reused from the previous one
+			ExportSettings.ExportDirectory = BenchmarkDirectory / PngCompressionName / FString::FromInt(MeshCount);
+			IFileManager::Get().DeleteDirectory(*ExportSettings.ExportDirectory, false, true);
+
+			UE_LOG(LogTemp, Display, TEXT("Benchmarking %d meshes, %s PNG"), MeshCount, *PngCompressionName);
+
+			if (!FUnrealToUnityExporterModule::RunUnrealToUnityExporter(ExportSettings))
+			{
+				ErrorCount++;
+			}
+
+			FUnrealToUnityExporterBenchmarkRun& Run = Results.Runs.AddDefaulted_GetRef();
+			Run.MeshCount = MeshCount;
+			Run.PngCompression = PngCompressionName;
+
+			FString ReportString;
+			if (!FFileHelper::LoadFileToString(ReportString, *(ExportSettings.ExportDirectory / TEXT("ExportReport.json"))) || !FJsonObjectConverter::JsonObjectStringToUStruct(ReportString, &Run.Report))
+			{
+				UE_LOG(LogTemp, Error, TEXT("Export report of %d meshes couldn't be read"), MeshCount);
+				ErrorCount++;
+			}
+
+			Run.Report.Assets.Empty();
+			Run.MeshesPerSecond = Run.Report.TotalSeconds > 0.0 ? MeshCount / Run.Report.TotalSeconds : 0.0;
+
+			UE_LOG(LogTemp, Display, TEXT("%d meshes, %s PNG: %.1f meshes/s, total %.2f s, load %.2f s, bake %.2f s, mesh export %.2f s, mip fetch %.2f s, encode %.2f s, write %.2f s, descriptor %.2f s, notify %.2f s, texture bytes %lld"),
+				MeshCount, *PngCompressionName, Run.MeshesPerSecond, Run.Report.TotalSeconds, Run.Report.LoadSeconds, Run.Report.BakeSeconds, Run.Report.MeshExportSeconds, Run.Report.MipFetchSeconds,
+				Run.Report.EncodeSeconds, Run.Report.WriteSeconds, Run.Report.DescriptorSaveSeconds, Run.Report.NotifySeconds, Run.Report.TextureBytesWritten);
+		}
+
+		DestroyObjects(StaticMeshes);
+	}
+
+	DestroyObjects(MaterialInstances);
+
+	FString ResultsString;
+	FJsonObjectConverter::UStructToJsonObjectString(Results, ResultsString);
+	FFileHelper::SaveStringToFile(ResultsString, *(BenchmarkDirectory / TEXT("BenchmarkResults.json")));
+
+	FString SaveBaselinePath;
+	if (FParse::Value(*Params, TEXT("SaveBaseline="), SaveBaselinePath) && !FFileHelper::SaveStringToFile(ResultsString, *SaveBaselinePath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Baseline couldn't be saved: %s"), *SaveBaselinePath);
+		ErrorCount++;
+	}
+
+	FString BaselinePath;
+	if (FParse::Value(*Params, TEXT("Baseline="), BaselinePath))
+	{
+		FString BaselineString;
+		FUnrealToUnityExporterBenchmarkResults Baseline;
+
+		if (!FFileHelper::LoadFileToString(BaselineString, *BaselinePath) || !FJsonObjectConverter::JsonObjectStringToUStruct(BaselineString, &Baseline))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Baseline couldn't be read: %s"), *BaselinePath);
+			ErrorCount++;
+		}
+		else if (Baseline.LodCount != Results.LodCount || Baseline.SectionCount != Results.SectionCount || Baseline.MaterialInstanceCount != Results.MaterialInstanceCount || Baseline.TextureSize != Results.TextureSize)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Baseline was recorded with different benchmark settings: %s"), *BaselinePath);
+			ErrorCount++;
+		}
+		else
+		{
+			ErrorCount += CompareWithBaseline(Results, Baseline, Tolerance);
+		}
+	}
+
+	return ErrorCount > 0 ? 1 : 0;
+}
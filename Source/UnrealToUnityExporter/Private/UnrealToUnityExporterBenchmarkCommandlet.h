@@ -0,0 +1,69 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UnrealToUnityExporterExportReport.h"
+#include "UnrealToUnityExporterBenchmarkCommandlet.generated.h"
+
+USTRUCT()
+struct FUnrealToUnityExporterBenchmarkRun
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 MeshCount = 0;
+
+	UPROPERTY()
+	FString PngCompression;
+
+	UPROPERTY()
+	double MeshesPerSecond = 0.0;
+
+	/** Export report of the run without the per asset entries */
+	UPROPERTY()
+	FUnrealToUnityExporterExportReportData Report;
+};
+
+USTRUCT()
+struct FUnrealToUnityExporterBenchmarkResults
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 LodCount = 0;
+
+	UPROPERTY()
+	int32 SectionCount = 0;
+
+	UPROPERTY()
+	int32 MaterialInstanceCount = 0;
+
+	UPROPERTY()
+	int32 TextureSize = 0;
+
+	UPROPERTY()
+	TArray<FUnrealToUnityExporterBenchmarkRun> Runs;
+};
+
+/**
+ * Measures export throughput on generated content, e.g. on a build agent to catch performance regressions:
+ *
+ * UnrealEditor-Cmd <Project> -run=UnrealToUnityExporterBenchmark [-Counts=10+100+1000+10000] [-LODs=1] [-Sections=2]
+ *     [-MaterialInstances=8] [-Resolution=8] [-TextureSize=256] [-PngCompressions=Default+Fast+Small]
+ *     [-Baseline=<Results.json>] [-Tolerance=0.2] [-SaveBaseline=<Results.json>]
+ *
+ * Every count runs the whole pipeline on that many transient meshes sharing MaterialInstances material instances,
+ * notifying the stand-in importer listener, once per PNG compression mode. The scaling curve is written to Saved/UnrealToUnityExporterBenchmark/BenchmarkResults.json.
+ * With a baseline, every phase of every count and mode present in both is compared per mesh and the commandlet fails if one
+ * got slower than the tolerance allows. Same rendering requirements as the export commandlet.
+ */
+UCLASS()
+class UUnrealToUnityExporterBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UUnrealToUnityExporterBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
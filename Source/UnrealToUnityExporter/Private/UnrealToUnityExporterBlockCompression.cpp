@@ -0,0 +1,530 @@
+﻿#include "UnrealToUnityExporterBlockCompression.h"
+
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	constexpr int32 BlockPixelCount = 16;
+
+	struct FBlockPixels
+	{
+		/** RGBA, 0 - 255 */
+		float Values[BlockPixelCount][4];
+	};
+
+	int32 GetBlockSize(EUnrealToUnityExporterTextureFormat Format)
+	{
+		return Format == EUnrealToUnityExporterTextureFormat::BC1 || Format == EUnrealToUnityExporterTextureFormat::BC4 ? 8 : 16;
+	}
+
+	/** Fits a line through the block in the first ChannelCount channels and returns the extreme points on it */
+	void FindPrincipalEndpoints(const FBlockPixels& Pixels, int32 ChannelCount, float OutEndpoint0[4], float OutEndpoint1[4])
+	{
+		float Mean[4] = {};
+		for (int32 PixelIndex = 0; PixelIndex < BlockPixelCount; PixelIndex++)
+		{
+			for (int32 Channel = 0; Channel < ChannelCount; Channel++)
+			{
+				Mean[Channel] += Pixels.Values[PixelIndex][Channel] / BlockPixelCount;
+			}
+		}
+
+		float Covariance[4][4] = {};
+		for (int32 PixelIndex = 0; PixelIndex < BlockPixelCount; PixelIndex++)
+		{
+			for (int32 Row = 0; Row < ChannelCount; Row++)
+			{
+				for (int32 Column = 0; Column < ChannelCount; Column++)
+				{
+					Covariance[Row][Column] += (Pixels.Values[PixelIndex][Row] - Mean[Row]) * (Pixels.Values[PixelIndex][Column] - Mean[Column]);
+				}
+			}
+		}
+
+		// A few power iterations are enough to find the dominant axis
+		float Axis[4] = { 1.f, 1.f, 1.f, 1.f };
+		for (int32 Iteration = 0; Iteration < 8; Iteration++)
+		{
+			float NextAxis[4] = {};
+			float Length = 0.f;
+
+			for (int32 Row = 0; Row < ChannelCount; Row++)
+			{
+				for (int32 Column = 0; Column < ChannelCount; Column++)
+				{
+					NextAxis[Row] += Covariance[Row][Column] * Axis[Column];
+				}
+
+				Length = FMath::Max(Length, FMath::Abs(NextAxis[Row]));
+			}
+
+			if (Length < UE_SMALL_NUMBER)
+			{
+				break;
+			}
+
+			for (int32 Channel = 0; Channel < ChannelCount; Channel++)
+			{
+				Axis[Channel] = NextAxis[Channel] / Length;
+			}
+		}
+
+		float MinProjection = UE_BIG_NUMBER;
+		float MaxProjection = -UE_BIG_NUMBER;
+		float AxisLengthSquared = 0.f;
+
+		for (int32 Channel = 0; Channel < ChannelCount; Channel++)
+		{
+			AxisLengthSquared += Axis[Channel] * Axis[Channel];
+		}
+
+		for (int32 PixelIndex = 0; PixelIndex < BlockPixelCount; PixelIndex++)
+		{
+			float Projection = 0.f;
+			for (int32 Channel = 0; Channel < ChannelCount; Channel++)
+			{
+				Projection += (Pixels.Values[PixelIndex][Channel] - Mean[Channel]) * Axis[Channel];
+			}
+
+			MinProjection = FMath::Min(MinProjection, Projection);
+			MaxProjection = FMath::Max(MaxProjection, Projection);
+		}
+
+		for (int32 Channel = 0; Channel < ChannelCount; Channel++)
+		{
+			const float Scale = AxisLengthSquared > UE_SMALL_NUMBER ? Axis[Channel] / AxisLengthSquared : 0.f;
+			OutEndpoint0[Channel] = FMath::Clamp(Mean[Channel] + MaxProjection * Scale, 0.f, 255.f);
+			OutEndpoint1[Channel] = FMath::Clamp(Mean[Channel] + MinProjection * Scale, 0.f, 255.f);
+		}
+	}
+
+	uint16 QuantizeRgb565(const float Color[4])
+	{
+		const uint32 R = FMath::RoundToInt(Color[0] * 31.f / 255.f);
+		const uint32 G = FMath::RoundToInt(Color[1] * 63.f / 255.f);
+		const uint32 B = FMath::RoundToInt(Color[2] * 31.f / 255.f);
+		return static_cast<uint16>((R << 11) | (G << 5) | B);
+	}
+
+	void ExpandRgb565(uint16 Color, float OutColor[4])
+	{
+		const uint32 R = (Color >> 11) & 31;
+		const uint32 G = (Color >> 5) & 63;
+		const uint32 B = Color & 31;
+		OutColor[0] = (R << 3) | (R >> 2);
+		OutColor[1] = (G << 2) | (G >> 4);
+		OutColor[2] = (B << 3) | (B >> 2);
+	}
+
+	void CompressBC1Block(const FBlockPixels& Pixels, uint8* OutBlock)
+	{
+		float Endpoint0[4];
+		float Endpoint1[4];
+		FindPrincipalEndpoints(Pixels, 3, Endpoint0, Endpoint1);
+
+		uint16 Color0 = QuantizeRgb565(Endpoint0);
+		uint16 Color1 = QuantizeRgb565(Endpoint1);
+
+		// Color0 > Color1 selects the four color mode
+		if (Color0 < Color1)
+		{
+			Swap(Color0, Color1);
+		}
+
+		uint32 Indices = 0;
+
+		if (Color0 != Color1)
+		{
+			float Palette[4][4];
+			ExpandRgb565(Color0, Palette[0]);
+			ExpandRgb565(Color1, Palette[1]);
+
+			for (int32 Channel = 0; Channel < 3; Channel++)
+			{
+				Palette[2][Channel] = (2.f * Palette[0][Channel] + Palette[1][Channel]) / 3.f;
+				Palette[3][Channel] = (Palette[0][Channel] + 2.f * Palette[1][Channel]) / 3.f;
+			}
+
+			for (int32 PixelIndex = 0; PixelIndex < BlockPixelCount; PixelIndex++)
+			{
+				int32 BestIndex = 0;
+				float BestError = UE_BIG_NUMBER;
+
+				for (int32 PaletteIndex = 0; PaletteIndex < 4; PaletteIndex++)
+				{
+					float Error = 0.f;
+					for (int32 Channel = 0; Channel < 3; Channel++)
+					{
+						Error += FMath::Square(Pixels.Values[PixelIndex][Channel] - Palette[PaletteIndex][Channel]);
+					}
+
+					if (Error < BestError)
+					{
+						BestError = Error;
+						BestIndex = PaletteIndex;
+					}
+				}
+
+				Indices |= BestIndex << (PixelIndex * 2);
+			}
+		}
+
+		FMemory::Memcpy(OutBlock, &Color0, 2);
+		FMemory::Memcpy(OutBlock + 2, &Color1, 2);
+		FMemory::Memcpy(OutBlock + 4, &Indices, 4);
+	}
+
+	void CompressBC4Block(const FBlockPixels& Pixels, int32 Channel, uint8* OutBlock)
+	{
+		float MinValue = 255.f;
+		float MaxValue = 0.f;
+
+		for (int32 PixelIndex = 0; PixelIndex < BlockPixelCount; PixelIndex++)
+		{
+			MinValue = FMath::Min(MinValue, Pixels.Values[PixelIndex][Channel]);
+			MaxValue = FMath::Max(MaxValue, Pixels.Values[PixelIndex][Channel]);
+		}
+
+		// Endpoint0 > Endpoint1 selects the eight value mode
+		const uint8 Endpoint0 = FMath::RoundToInt(MaxValue);
+		const uint8 Endpoint1 = FMath::RoundToInt(MinValue);
+		uint64 Indices = 0;
+
+		if (Endpoint0 > Endpoint1)
+		{
+			for (int32 PixelIndex = 0; PixelIndex < BlockPixelCount; PixelIndex++)
+			{
+				const int32 Weight = FMath::Clamp(FMath::RoundToInt((Endpoint0 - Pixels.Values[PixelIndex][Channel]) * 7.f / (Endpoint0 - Endpoint1)), 0, 7);
+				const uint64 Index = Weight == 0 ? 0 : Weight == 7 ? 1 : Weight + 1;
+				Indices |= Index << (PixelIndex * 3);
+			}
+		}
+
+		OutBlock[0] = Endpoint0;
+		OutBlock[1] = Endpoint1;
+		FMemory::Memcpy(OutBlock + 2, &Indices, 6);
+	}
+
+	struct FBitWriter
+	{
+		uint64 Bits[2] = {};
+		int32 Position = 0;
+
+		void Write(uint64 Value, int32 BitCount)
+		{
+			for (int32 BitIndex = 0; BitIndex < BitCount; BitIndex++, Position++)
+			{
+				Bits[Position / 64] |= ((Value >> BitIndex) & 1) << (Position % 64);
+			}
+		}
+	};
+
+	/** Quantizes an endpoint to 7 bits per channel plus the p-bit shared by all its channels */
+	void QuantizeBC7Mode6Endpoint(const float Endpoint[4], uint8 OutQuantized[4], uint8& OutPBit)
+	{
+		float BestError = UE_BIG_NUMBER;
+
+		for (uint8 PBit = 0; PBit < 2; PBit++)
+		{
+			uint8 Quantized[4];
+			float Error = 0.f;
+
+			for (int32 Channel = 0; Channel < 4; Channel++)
+			{
+				Quantized[Channel] = FMath::Clamp(FMath::RoundToInt((Endpoint[Channel] - PBit) / 2.f), 0, 127);
+				Error += FMath::Square(Endpoint[Channel] - (Quantized[Channel] * 2 + PBit));
+			}
+
+			if (Error < BestError)
+			{
+				BestError = Error;
+				OutPBit = PBit;
+				FMemory::Memcpy(OutQuantized, Quantized, sizeof(Quantized));
+			}
+		}
+	}
+
+	void CompressBC7Block(const FBlockPixels& Pixels, uint8* OutBlock)
+	{
+		static constexpr int32 Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		float Endpoints[2][4];
+		FindPrincipalEndpoints(Pixels, 4, Endpoints[0], Endpoints[1]);
+
+		uint8 Quantized[2][4];
+		uint8 PBits[2];
+		QuantizeBC7Mode6Endpoint(Endpoints[0], Quantized[0], PBits[0]);
+		QuantizeBC7Mode6Endpoint(Endpoints[1], Quantized[1], PBits[1]);
+
+		int32 Palette[16][4];
+		for (int32 PaletteIndex = 0; PaletteIndex < 16; PaletteIndex++)
+		{
+			for (int32 Channel = 0; Channel < 4; Channel++)
+			{
+				const int32 Value0 = Quantized[0][Channel] * 2 + PBits[0];
+				const int32 Value1 = Quantized[1][Channel] * 2 + PBits[1];
+				Palette[PaletteIndex][Channel] = ((64 - Weights[PaletteIndex]) * Value0 + Weights[PaletteIndex] * Value1 + 32) >> 6;
+			}
+		}
+
+		uint8 Indices[BlockPixelCount];
+		for (int32 PixelIndex = 0; PixelIndex < BlockPixelCount; PixelIndex++)
+		{
+			float BestError = UE_BIG_NUMBER;
+
+			for (int32 PaletteIndex = 0; PaletteIndex < 16; PaletteIndex++)
+			{
+				float Error = 0.f;
+				for (int32 Channel = 0; Channel < 4; Channel++)
+				{
+					Error += FMath::Square(Pixels.Values[PixelIndex][Channel] - Palette[PaletteIndex][Channel]);
+				}
+
+				if (Error < BestError)
+				{
+					BestError = Error;
+					Indices[PixelIndex] = PaletteIndex;
+				}
+			}
+		}
+
+		// Most significant bit of the first index is implicit zero, swapping the endpoints flips it
+		if (Indices[0] & 8)
+		{
+			Swap(Quantized[0], Quantized[1]);
+			Swap(PBits[0], PBits[1]);
+
+			for (uint8& Index : Indices)
+			{
+				Index = 15 - Index;
+			}
+		}
+
+		FBitWriter BitWriter;
+		BitWriter.Write(1 << 6, 7);
+
+		for (int32 Channel = 0; Channel < 4; Channel++)
+		{
+			BitWriter.Write(Quantized[0][Channel], 7);
+			BitWriter.Write(Quantized[1][Channel], 7);
+		}
+
+		BitWriter.Write(PBits[0], 1);
+		BitWriter.Write(PBits[1], 1);
+		BitWriter.Write(Indices[0], 3);
+
+		for (int32 PixelIndex = 1; PixelIndex < BlockPixelCount; PixelIndex++)
+		{
+			BitWriter.Write(Indices[PixelIndex], 4);
+		}
+
+		FMemory::Memcpy(OutBlock, BitWriter.Bits, 16);
+	}
+
+	void CompressBlock(const FBlockPixels& Pixels, EUnrealToUnityExporterTextureFormat Format, uint8* OutBlock)
+	{
+		switch (Format)
+		{
+		case EUnrealToUnityExporterTextureFormat::BC1:
+			CompressBC1Block(Pixels, OutBlock);
+			break;
+		case EUnrealToUnityExporterTextureFormat::BC3:
+			CompressBC4Block(Pixels, 3, OutBlock);
+			CompressBC1Block(Pixels, OutBlock + 8);
+			break;
+		case EUnrealToUnityExporterTextureFormat::BC4:
+			CompressBC4Block(Pixels, 0, OutBlock);
+			break;
+		case EUnrealToUnityExporterTextureFormat::BC5:
+			CompressBC4Block(Pixels, 0, OutBlock);
+			CompressBC4Block(Pixels, 1, OutBlock + 8);
+			break;
+		case EUnrealToUnityExporterTextureFormat::BC7:
+			CompressBC7Block(Pixels, OutBlock);
+			break;
+		default:
+			checkNoEntry();
+		}
+	}
+
+	/** Appends the blocks of a BGRA8 mip, edge pixels are repeated to fill partial blocks */
+	void CompressMip(const FImage& Mip, EUnrealToUnityExporterTextureFormat Format, TArray64<uint8>& OutData)
+	{
+		const int32 BlockCountX = FMath::DivideAndRoundUp(Mip.SizeX, 4);
+		const int32 BlockCountY = FMath::DivideAndRoundUp(Mip.SizeY, 4);
+		const int32 BlockSize = GetBlockSize(Format);
+		const int64 RowSize = static_cast<int64>(BlockCountX) * BlockSize;
+
+		const int64 MipOffset = OutData.Num();
+		OutData.AddUninitialized(RowSize * BlockCountY);
+
+		const TArrayView64<const FColor> Colors = Mip.AsBGRA8();
+
+		ParallelFor(BlockCountY, [&] (int32 BlockY)
+		{
+			for (int32 BlockX = 0; BlockX < BlockCountX; BlockX++)
+			{
+				FBlockPixels Pixels;
+
+				for (int32 PixelIndex = 0; PixelIndex < BlockPixelCount; PixelIndex++)
+				{
+					const int32 X = FMath::Min(BlockX * 4 + PixelIndex % 4, Mip.SizeX - 1);
+					const int32 Y = FMath::Min(BlockY * 4 + PixelIndex / 4, Mip.SizeY - 1);
+					const FColor& Color = Colors[static_cast<int64>(Y) * Mip.SizeX + X];
+
+					Pixels.Values[PixelIndex][0] = Color.R;
+					Pixels.Values[PixelIndex][1] = Color.G;
+					Pixels.Values[PixelIndex][2] = Color.B;
+					Pixels.Values[PixelIndex][3] = Color.A;
+				}
+
+				CompressBlock(Pixels, Format, OutData.GetData() + MipOffset + BlockY * RowSize + BlockX * BlockSize);
+			}
+		});
+	}
+
+	/**
+	 * 2x2 box filter on a linear RGBA32F mip, odd edges repeat their last row or column.
+	 * Normals are averaged as vectors and renormalized, Z is rebuilt from XY as BC5 doesn't store it.
+	 */
+	FImage DownsampleMip(const FImage& LinearMip, bool bIsNormalMap)
+	{
+		FImage NextMip(FMath::Max(LinearMip.SizeX / 2, 1), FMath::Max(LinearMip.SizeY / 2, 1), ERawImageFormat::RGBA32F, EGammaSpace::Linear);
+
+		const TArrayView64<const FLinearColor> Colors = LinearMip.AsRGBA32F();
+		const TArrayView64<FLinearColor> NextColors = NextMip.AsRGBA32F();
+
+		for (int32 Y = 0; Y < NextMip.SizeY; Y++)
+		{
+			for (int32 X = 0; X < NextMip.SizeX; X++)
+			{
+				FLinearColor Sum(0.f, 0.f, 0.f, 0.f);
+				FVector3f NormalSum = FVector3f::ZeroVector;
+
+				for (int32 SampleIndex = 0; SampleIndex < 4; SampleIndex++)
+				{
+					const int32 SampleX = FMath::Min(X * 2 + SampleIndex % 2, LinearMip.SizeX - 1);
+					const int32 SampleY = FMath::Min(Y * 2 + SampleIndex / 2, LinearMip.SizeY - 1);
+					const FLinearColor& Color = Colors[static_cast<int64>(SampleY) * LinearMip.SizeX + SampleX];
+
+					Sum += Color;
+
+					if (bIsNormalMap)
+					{
+						const float NormalX = Color.R * 2.f - 1.f;
+						const float NormalY = Color.G * 2.f - 1.f;
+						NormalSum += FVector3f(NormalX, NormalY, FMath::Sqrt(FMath::Max(1.f - NormalX * NormalX - NormalY * NormalY, 0.f)));
+					}
+				}
+
+				FLinearColor& NextColor = NextColors[static_cast<int64>(Y) * NextMip.SizeX + X];
+				NextColor = Sum * 0.25f;
+
+				if (bIsNormalMap)
+				{
+					const FVector3f Normal = NormalSum.GetSafeNormal(UE_SMALL_NUMBER, FVector3f::ZAxisVector);
+					NextColor.R = Normal.X * 0.5f + 0.5f;
+					NextColor.G = Normal.Y * 0.5f + 0.5f;
+					NextColor.B = Normal.Z * 0.5f + 0.5f;
+				}
+			}
+		}
+
+		return NextMip;
+	}
+
+	uint32 GetDxgiFormat(EUnrealToUnityExporterTextureFormat Format, bool bIsSRGB)
+	{
+		switch (Format)
+		{
+		case EUnrealToUnityExporterTextureFormat::BC1: return bIsSRGB ? 72 : 71;
+		case EUnrealToUnityExporterTextureFormat::BC3: return bIsSRGB ? 78 : 77;
+		case EUnrealToUnityExporterTextureFormat::BC4: return 80;
+		case EUnrealToUnityExporterTextureFormat::BC5: return 83;
+		case EUnrealToUnityExporterTextureFormat::BC7: return bIsSRGB ? 99 : 98;
+		default: return 0;
+		}
+	}
+
+	void WriteDdsHeader(int32 SizeX, int32 SizeY, int32 MipCount, int64 Mip0Size, uint32 DxgiFormat, TArray64<uint8>& OutData)
+	{
+		uint32 Header[1 + 31 + 5] = {};
+
+		Header[0] = 0x20534444; // "DDS "
+		Header[1] = 124; // Header size
+		Header[2] = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000; // Caps, height, width, pixel format, mip count, linear size
+		Header[3] = SizeY;
+		Header[4] = SizeX;
+		Header[5] = static_cast<uint32>(Mip0Size);
+		Header[7] = MipCount;
+		Header[19] = 32; // Pixel format size
+		Header[20] = 0x4; // Four CC
+		Header[21] = 0x30315844; // "DX10"
+		Header[27] = 0x1000 | 0x400000 | 0x8; // Texture, mip map, complex
+		Header[32] = DxgiFormat;
+		Header[33] = 3; // Texture 2D
+		Header[35] = 1; // Array size
+
+		OutData.Append(reinterpret_cast<const uint8*>(Header), sizeof(Header));
+	}
+}
+
+TArray64<uint8> FUnrealToUnityExporterBlockCompression::CompressToDds(const FImage& Image, EUnrealToUnityExporterTextureFormat Format)
+{
+	TArray64<uint8> Data;
+
+	if (Format == EUnrealToUnityExporterTextureFormat::PNG || Image.SizeX <= 0 || Image.SizeY <= 0)
+	{
+		return Data;
+	}
+
+	const bool bIsSRGB = Image.GammaSpace == EGammaSpace::sRGB;
+	const bool bIsNormalMap = Format == EUnrealToUnityExporterTextureFormat::BC5;
+
+	FImage Mip;
+	Image.CopyTo(Mip, ERawImageFormat::BGRA8, bIsSRGB ? EGammaSpace::sRGB : EGammaSpace::Linear);
+
+	// Lower mips are filtered in linear space, averaging sRGB values would darken them
+	FImage LinearMip;
+
+	const int32 MipCount = FMath::FloorLog2(FMath::Max(Mip.SizeX, Mip.SizeY)) + 1;
+	const int64 Mip0Size = static_cast<int64>(FMath::DivideAndRoundUp(Mip.SizeX, 4)) * FMath::DivideAndRoundUp(Mip.SizeY, 4) * GetBlockSize(Format);
+
+	WriteDdsHeader(Mip.SizeX, Mip.SizeY, MipCount, Mip0Size, GetDxgiFormat(Format, bIsSRGB), Data);
+
+	for (int32 MipIndex = 0; MipIndex < MipCount; MipIndex++)
+	{
+		CompressMip(Mip, Format, Data);
+
+		if (MipIndex + 1 < MipCount)
+		{
+			if (MipIndex == 0)
+			{
+				Image.CopyTo(LinearMip, ERawImageFormat::RGBA32F, EGammaSpace::Linear);
+			}
+
+			LinearMip = DownsampleMip(LinearMip, bIsNormalMap);
+			LinearMip.CopyTo(Mip, ERawImageFormat::BGRA8, bIsSRGB ? EGammaSpace::sRGB : EGammaSpace::Linear);
+		}
+	}
+
+	return Data;
+}
+
+const TCHAR* FUnrealToUnityExporterBlockCompression::GetFormatName(EUnrealToUnityExporterTextureFormat Format)
+{
+	switch (Format)
+	{
+	case EUnrealToUnityExporterTextureFormat::BC1: return TEXT("BC1");
+	case EUnrealToUnityExporterTextureFormat::BC3: return TEXT("BC3");
+	case EUnrealToUnityExporterTextureFormat::BC4: return TEXT("BC4");
+	case EUnrealToUnityExporterTextureFormat::BC5: return TEXT("BC5");
+	case EUnrealToUnityExporterTextureFormat::BC7: return TEXT("BC7");
+	default: return TEXT("PNG");
+	}
+}
+
+const TCHAR* FUnrealToUnityExporterBlockCompression::GetFileExtension(EUnrealToUnityExporterTextureFormat Format)
+{
+	return Format == EUnrealToUnityExporterTextureFormat::PNG ? TEXT("png") : TEXT("dds");
+}
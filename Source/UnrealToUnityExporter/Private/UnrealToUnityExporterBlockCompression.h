@@ -0,0 +1,28 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "ImageCore.h"
+
+enum class EUnrealToUnityExporterTextureFormat : uint8
+{
+	PNG,
+	BC1,
+	BC3,
+	BC4,
+	BC5,
+	BC7,
+};
+
+/**
+ * CPU block compression into DDS files (DX10 header) with a full mip chain, so Unity can use exported textures as they are.
+ * BC1 and BC3 use principal axis endpoint fitting, BC4 and BC5 min/max fitting and BC7 only mode 6, which trades some quality
+ * for being fast enough to compress every baked texture. Block rows are compressed in parallel.
+ */
+struct FUnrealToUnityExporterBlockCompression
+{
+	/** Returns an empty array for PNG */
+	static TArray64<uint8> CompressToDds(const FImage& Image, EUnrealToUnityExporterTextureFormat Format);
+
+	static const TCHAR* GetFormatName(EUnrealToUnityExporterTextureFormat Format);
+	static const TCHAR* GetFileExtension(EUnrealToUnityExporterTextureFormat Format);
+};
@@ -0,0 +1,173 @@
+﻿#include "UnrealToUnityExporterCommandlet.h"
+
+#include "SExportSettingsWindow.h"
+#include "UnrealToUnityExporter.h"
+#include "UnrealToUnityExporterAssetSearch.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Dom/JsonObject.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace
+{
+	void ParseListSwitch(const FString& Params, const TCHAR* Switch, TArray<FString>& OutValues)
+	{
+		FString Value;
+		if (FParse::Value(*Params, Switch, Value, false))
+		{
+			TArray<FString> Values;
+			Value.ParseIntoArray(Values, TEXT("+"));
+			OutValues.Append(Values);
+		}
+	}
+}
+
+UUnrealToUnityExporterCommandlet::UUnrealToUnityExporterCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UUnrealToUnityExporterCommandlet::Main(const FString& Params)
+{
+	FExportSettings ExportSettings;
+	ExportSettings.bNotifyUnity = false;
+
+	TArray<FString> FolderPaths;
+	TArray<FString> ExcludeStrings;
+	TArray<FString> ExcludeAssetPaths;
+	TArray<FString> AssetPaths;
+
+	FString SettingsPath;
+	if (FParse::Value(*Params, TEXT("Settings="), SettingsPath))
+	{
+		FString JsonString;
+		TSharedPtr<FJsonObject> JsonObject;
+
+		if (!FFileHelper::LoadFileToString(JsonString, *SettingsPath) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(JsonString), JsonObject) || !JsonObject.IsValid())
+		{
+			UE_LOG(LogTemp, Error, TEXT("Settings file couldn't be read: %s"), *SettingsPath);
+			return 1;
+		}
+
+		JsonObject->TryGetNumberField(TEXT("TextureSize"), ExportSettings.TextureSize);
+		JsonObject->TryGetBoolField(TEXT("bEnableReadWrite"), ExportSettings.bEnableReadWrite);
+		JsonObject->TryGetBoolField(TEXT("bUseExportCache"), ExportSettings.bUseExportCache);
+		JsonObject->TryGetBoolField(TEXT("bUseBakeCache"), ExportSettings.bUseBakeCache);
+		JsonObject->TryGetBoolField(TEXT("bResumeExport"), ExportSettings.bResumeExport);
+		JsonObject->TryGetBoolField(TEXT("bNotifyUnity"), ExportSettings.bNotifyUnity);
+		JsonObject->TryGetBoolField(TEXT("bBinaryImportDescriptor"), ExportSettings.bBinaryImportDescriptor);
+		JsonObject->TryGetBoolField(TEXT("bUniformTexturesAsConstants"), ExportSettings.bUniformTexturesAsConstants);
+		JsonObject->TryGetNumberField(TEXT("UniformTextureTolerance"), ExportSettings.UniformTextureTolerance);
+		JsonObject->TryGetBoolField(TEXT("bCompressedTextures"), ExportSettings.bCompressedTextures);
+		JsonObject->TryGetBoolField(TEXT("bFastBlockCompression"), ExportSettings.bFastBlockCompression);
+		JsonObject->TryGetBoolField(TEXT("bPackMaskMaps"), ExportSettings.bPackMaskMaps);
+		JsonObject->TryGetBoolField(TEXT("bPassThroughMaterials"), ExportSettings.bPassThroughMaterials);
+		JsonObject->TryGetBoolField(TEXT("bMergeEquivalentMaterials"), ExportSettings.bMergeEquivalentMaterials);
+
+		FString PngCompressionString;
+		if (JsonObject->TryGetStringField(TEXT("PngCompression"), PngCompressionString))
+		{
+			LexFromString(ExportSettings.PngCompression, *PngCompressionString);
+		}
+
+		FString LodStrategyString;
+		if (JsonObject->TryGetStringField(TEXT("LodStrategy"), LodStrategyString))
+		{
+			LexFromString(ExportSettings.LodStrategy, *LodStrategyString);
+		}
+		JsonObject->TryGetNumberField(TEXT("MeshesPerBatch"), ExportSettings.MeshesPerBatch);
+		JsonObject->TryGetNumberField(TEXT("MaterialsPerBake"), ExportSettings.MaterialsPerBake);
+		JsonObject->TryGetNumberField(TEXT("TextureWriterThreads"), ExportSettings.TextureWriterThreads);
+		JsonObject->TryGetNumberField(TEXT("MeshExportProcesses"), ExportSettings.MeshExportProcesses);
+		JsonObject->TryGetStringField(TEXT("ExportDirectory"), ExportSettings.ExportDirectory);
+		JsonObject->TryGetStringArrayField(TEXT("Folders"), FolderPaths);
+		JsonObject->TryGetStringArrayField(TEXT("ExcludeStrings"), ExcludeStrings);
+		JsonObject->TryGetStringArrayField(TEXT("ExcludeAssetPaths"), ExcludeAssetPaths);
+		JsonObject->TryGetStringArrayField(TEXT("Assets"), AssetPaths);
+	}
+
+	// Command line switches override the settings file
+	FParse::Value(*Params, TEXT("TextureSize="), ExportSettings.TextureSize);
+	FParse::Value(*Params, TEXT("ExportDirectory="), ExportSettings.ExportDirectory);
+	ExportSettings.bEnableReadWrite |= FParse::Param(*Params, TEXT("EnableReadWrite"));
+	ExportSettings.bUseExportCache &= !FParse::Param(*Params, TEXT("NoExportCache"));
+	ExportSettings.bUseBakeCache &= !FParse::Param(*Params, TEXT("NoBakeCache"));
+	ExportSettings.bResumeExport |= FParse::Param(*Params, TEXT("Resume"));
+	ExportSettings.bNotifyUnity |= FParse::Param(*Params, TEXT("NotifyUnity"));
+	ExportSettings.bBinaryImportDescriptor |= FParse::Param(*Params, TEXT("BinaryImportDescriptor"));
+	ExportSettings.bUniformTexturesAsConstants &= !FParse::Param(*Params, TEXT("KeepUniformTextures"));
+	FParse::Value(*Params, TEXT("UniformTextureTolerance="), ExportSettings.UniformTextureTolerance);
+	FParse::Value(*Params, TEXT("MeshExportProcesses="), ExportSettings.MeshExportProcesses);
+	FParse::Value(*Params, TEXT("MaterialsPerBake="), ExportSettings.MaterialsPerBake);
+	ExportSettings.bCompressedTextures |= FParse::Param(*Params, TEXT("CompressedTextures"));
+	ExportSettings.bFastBlockCompression |= FParse::Param(*Params, TEXT("FastBlockCompression"));
+	ExportSettings.bPackMaskMaps |= FParse::Param(*Params, TEXT("PackMaskMaps"));
+	ExportSettings.bPassThroughMaterials &= !FParse::Param(*Params, TEXT("BakeAllMaterials"));
+	ExportSettings.bMergeEquivalentMaterials &= !FParse::Param(*Params, TEXT("KeepEquivalentMaterials"));
+
+	FString PngCompressionString;
+	if (FParse::Value(*Params, TEXT("PngCompression="), PngCompressionString))
+	{
+		LexFromString(ExportSettings.PngCompression, *PngCompressionString);
+	}
+
+	FString LodStrategyString;
+	if (FParse::Value(*Params, TEXT("LodStrategy="), LodStrategyString))
+	{
+		LexFromString(ExportSettings.LodStrategy, *LodStrategyString);
+	}
+	ParseListSwitch(Params, TEXT("Folders="), FolderPaths);
+	ParseListSwitch(Params, TEXT("ExcludeStrings="), ExcludeStrings);
+	ParseListSwitch(Params, TEXT("ExcludeAssets="), ExcludeAssetPaths);
+	ParseListSwitch(Params, TEXT("Assets="), AssetPaths);
+
+	// The registry isn't scanned up front when running as a commandlet
+	IAssetRegistry& AssetRegistry = FModuleManager::Get().LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	TArray<FAssetData> Assets;
+	int32 ErrorCount = 0;
+
+	if (!AssetPaths.IsEmpty())
+	{
+		ErrorCount += FUnrealToUnityExporterAssetSearch::FindAssetsByObjectPaths(AssetPaths, Assets);
+	}
+
+	if (!FolderPaths.IsEmpty())
+	{
+		ErrorCount += FUnrealToUnityExporterAssetSearch::FindAssetsInFolders(FolderPaths, ExcludeStrings, ExcludeAssetPaths, Assets);
+	}
+
+	TSet<FSoftObjectPath> AddedAssetPaths;
+
+	for (FAssetData& Asset : Assets)
+	{
+		bool bIsAlreadyAdded = false;
+		AddedAssetPaths.Add(Asset.GetSoftObjectPath(), &bIsAlreadyAdded);
+
+		if (!bIsAlreadyAdded)
+		{
+			ExportSettings.SelectedAssets.Add(MakeShared<FAssetData>(MoveTemp(Asset)));
+		}
+	}
+
+	if (ExportSettings.SelectedAssets.IsEmpty())
+	{
+		UE_LOG(LogTemp, Error, TEXT("No static meshes found to export, pass -Folders=, -Assets= or a -Settings= file"));
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Exporting %d static meshes"), ExportSettings.SelectedAssets.Num());
+
+	if (!FUnrealToUnityExporterModule::RunUnrealToUnityExporter(ExportSettings))
+	{
+		++ErrorCount;
+	}
+
+	return ErrorCount > 0 ? 1 : 0;
+}
@@ -0,0 +1,29 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UnrealToUnityExporterCommandlet.generated.h"
+
+/**
+ * Runs the exporter without the editor UI, e.g. on build agents:
+ *
+ * UnrealEditor-Cmd <Project> -run=UnrealToUnityExporter -Settings=<Settings.json> [-Folders=/Game/A+/Game/B] [-Assets=<ObjectPath>+...]
+ *     [-ExcludeStrings=<A>+<B>] [-ExcludeAssets=<ObjectPath>+...] [-TextureSize=2048] [-EnableReadWrite] [-NoExportCache] [-NoBakeCache] [-Resume]
+ *     [-ExportDirectory=<Path>] [-NotifyUnity] [-BinaryImportDescriptor]
+ *     [-KeepUniformTextures] [-UniformTextureTolerance=2] [-CompressedTextures] [-FastBlockCompression]
+ *     [-PngCompression=Default|Fast|Small] [-PackMaskMaps] [-MeshExportProcesses=0] [-BakeAllMaterials]
+ *     [-LodStrategy=AllLods|Lod0Only|FirstOccurrence] [-MaterialsPerBake=8] [-KeepEquivalentMaterials]
+ *
+ * Material baking renders on the GPU so -nullrhi can't be used, pass -AllowCommandletRendering -RenderOffscreen instead
+ * (Linux agents without a GPU need a software Vulkan driver). Returns non zero if anything failed to export.
+ */
+UCLASS()
+class UUnrealToUnityExporterCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UUnrealToUnityExporterCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,262 @@
+﻿#include "UnrealToUnityExporterDescriptorWriter.h"
+
+#include "JsonObjectConverter.h"
+#include "Serialization/MemoryWriter.h"
+
+FUnrealToUnityExporterDescriptorWriter::FUnrealToUnityExporterDescriptorWriter(const FString& InExportDirectory, bool bInIsBinary)
+	: ExportDirectory(InExportDirectory)
+	, bIsBinary(bInIsBinary)
+	, SavePath(InExportDirectory / (bInIsBinary ? TEXT("ImportDescriptor.bin") : TEXT("ImportDescriptor.txt")))
+	, TempSavePath(SavePath + TEXT(".tmp"))
+	, TempMeshesPath(InExportDirectory / TEXT("ImportDescriptorMeshes.tmp"))
+{
+}
+
+FUnrealToUnityExporterDescriptorWriter::~FUnrealToUnityExporterDescriptorWriter()
+{
+	if (Writer)
+	{
+		Abort();
+	}
+}
+
+bool FUnrealToUnityExporterDescriptorWriter::Open()
+{
+	IFileManager& FileManager = IFileManager::Get();
+
+	Writer.Reset(FileManager.CreateFileWriter(*TempSavePath));
+
+	if (!bIsBinary)
+	{
+		MeshesWriter.Reset(FileManager.CreateFileWriter(*TempMeshesPath));
+	}
+
+	if (!Writer || (!bIsBinary && !MeshesWriter))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Import descriptor couldn't be opened: %s"), *TempSavePath);
+		Abort();
+		return false;
+	}
+
+	WriteHeader();
+	return true;
+}
+
+void FUnrealToUnityExporterDescriptorWriter::AddMaterial(const FUnrealToUnityExporterMaterialDescriptor& MaterialDescriptor)
+{
+	if (!Writer)
+	{
+		return;
+	}
+
+	bool bIsAlreadyWritten = false;
+	WrittenMaterialPaths.Add(MaterialDescriptor.MaterialPath, &bIsAlreadyWritten);
+
+	if (bIsAlreadyWritten)
+	{
+		return;
+	}
+
+	if (!bIsBinary)
+	{
+		FString JsonString;
+		FJsonObjectConverter::UStructToJsonObjectString(MaterialDescriptor, JsonString, 0, 0, 0, nullptr, false /*bPrettyPrint*/);
+
+		if (WrittenMaterialPaths.Num() > 1)
+		{
+			JsonString.InsertAt(0, TEXT(','));
+		}
+
+		WriteJsonRecord(*Writer, JsonString);
+		return;
+	}
+
+	TArray<uint8> Payload;
+	FMemoryWriter PayloadWriter(Payload);
+
+	WriteString(PayloadWriter, MaterialDescriptor.MaterialPath);
+	int32 BlendMode = MaterialDescriptor.BlendMode;
+	PayloadWriter << BlendMode;
+	uint32 TextureCount = MaterialDescriptor.TextureDescriptors.Num();
+	PayloadWriter << TextureCount;
+
+	for (const FUnrealToUnityExporterTextureDescriptor& TextureDescriptor : MaterialDescriptor.TextureDescriptors)
+	{
+		uint8 Flags = (TextureDescriptor.bUseTexture ? 1 : 0) | (TextureDescriptor.bUseColor ? 2 : 0) | (TextureDescriptor.bUseScalar ? 4 : 0);
+		FLinearColor Color = TextureDescriptor.Color;
+		float Scalar = TextureDescriptor.Scalar;
+
+		PayloadWriter << Flags;
+		PayloadWriter << Color.R << Color.G << Color.B << Color.A;
+		PayloadWriter << Scalar;
+		WriteString(PayloadWriter, TextureDescriptor.ParameterName);
+		WriteString(PayloadWriter, TextureDescriptor.TexturePath);
+		WriteString(PayloadWriter, TextureDescriptor.TextureFormat);
+	}
+
+	WriteString(PayloadWriter, MaterialDescriptor.MaskMapPath);
+	WriteString(PayloadWriter, MaterialDescriptor.MaskMapFormat);
+
+	WriteBinaryRecord(Payload, MaterialRecordOffsets);
+}
+
+void FUnrealToUnityExporterDescriptorWriter::AddMesh(const FUnrealToUnityExporterMeshDescriptor& MeshDescriptor)
+{
+	if (!Writer)
+	{
+		return;
+	}
+
+	if (!bIsBinary)
+	{
+		FString JsonString;
+		FJsonObjectConverter::UStructToJsonObjectString(MeshDescriptor, JsonString, 0, 0, 0, nullptr, false /*bPrettyPrint*/);
+
+		if (JsonMeshCount++ > 0)
+		{
+			JsonString.InsertAt(0, TEXT(','));
+		}
+
+		WriteJsonRecord(*MeshesWriter, JsonString);
+		return;
+	}
+
+	TArray<uint8> Payload;
+	FMemoryWriter PayloadWriter(Payload);
+
+	WriteString(PayloadWriter, MeshDescriptor.MeshPath);
+	uint8 bEnableReadWrite = MeshDescriptor.bEnableReadWrite ? 1 : 0;
+	PayloadWriter << bEnableReadWrite;
+
+	WriteBinaryRecord(Payload, MeshRecordOffsets);
+}
+
+FString FUnrealToUnityExporterDescriptorWriter::Finish()
+{
+	if (!Writer)
+	{
+		return FString();
+	}
+
+	IFileManager& FileManager = IFileManager::Get();
+
+	if (!bIsBinary)
+	{
+		WriteJsonRecord(*Writer, FString::Printf(TEXT("],\"%s\":["), *FJsonObjectConverter::StandardizeCase(TEXT("MeshDescriptors"))));
+
+		MeshesWriter->Close();
+		bHasError |= MeshesWriter->IsError();
+		MeshesWriter.Reset();
+
+		// Copied in chunks, the mesh list is never held in memory as a whole
+		if (const TUniquePtr<FArchive> MeshesReader(FileManager.CreateFileReader(*TempMeshesPath)); MeshesReader)
+		{
+			TArray<uint8> Buffer;
+			Buffer.SetNumUninitialized(1024 * 1024);
+
+			for (int64 RemainingSize = MeshesReader->TotalSize(); RemainingSize > 0;)
+			{
+				const int64 ChunkSize = FMath::Min<int64>(RemainingSize, Buffer.Num());
+				MeshesReader->Serialize(Buffer.GetData(), ChunkSize);
+				Writer->Serialize(Buffer.GetData(), ChunkSize);
+				RemainingSize -= ChunkSize;
+			}
+		}
+		else
+		{
+			bHasError = true;
+		}
+
+		WriteJsonRecord(*Writer, TEXT("]}"));
+	}
+	else
+	{
+		uint64 MaterialOffsetsOffset = Writer->Tell();
+		Writer->Serialize(MaterialRecordOffsets.GetData(), MaterialRecordOffsets.Num() * sizeof(uint64));
+		uint64 MeshOffsetsOffset = Writer->Tell();
+		Writer->Serialize(MeshRecordOffsets.GetData(), MeshRecordOffsets.Num() * sizeof(uint64));
+
+		// Counts and table offsets are only known now
+		uint32 MaterialCount = MaterialRecordOffsets.Num();
+		uint32 MeshCount = MeshRecordOffsets.Num();
+		Writer->Seek(8);
+		*Writer << MaterialCount << MeshCount << MaterialOffsetsOffset << MeshOffsetsOffset;
+	}
+
+	Writer->Close();
+	bHasError |= Writer->IsError();
+	Writer.Reset();
+	FileManager.Delete(*TempMeshesPath, false, false, true /*bQuiet*/);
+
+	if (bHasError || !FileManager.Move(*SavePath, *TempSavePath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Import descriptor couldn't be saved: %s"), *SavePath);
+		FileManager.Delete(*TempSavePath, false, false, true /*bQuiet*/);
+		return FString();
+	}
+
+	return SavePath;
+}
+
+void FUnrealToUnityExporterDescriptorWriter::WriteHeader()
+{
+	FUnrealToUnityExporterImportDescriptorHeader Header;
+	Header.ExportDirectory = ExportDirectory;
+
+	if (!bIsBinary)
+	{
+		FString JsonString;
+		FJsonObjectConverter::UStructToJsonObjectString(Header, JsonString, 0, 0, 0, nullptr, false /*bPrettyPrint*/);
+
+		// Header object is left open so the arrays can follow
+		JsonString.LeftChopInline(1);
+		JsonString += FString::Printf(TEXT(",\"%s\":["), *FJsonObjectConverter::StandardizeCase(TEXT("MaterialDescriptors")));
+
+		WriteJsonRecord(*Writer, JsonString);
+		return;
+	}
+
+	ANSICHAR Magic[4] = { 'U', 'T', 'U', 'D' };
+	uint32 Version = BinaryVersion;
+	uint32 MaterialCount = 0;
+	uint32 MeshCount = 0;
+	uint64 MaterialOffsetsOffset = 0;
+	uint64 MeshOffsetsOffset = 0;
+
+	Writer->Serialize(Magic, sizeof(Magic));
+	*Writer << Version << MaterialCount << MeshCount << MaterialOffsetsOffset << MeshOffsetsOffset;
+	WriteString(*Writer, Header.ExportDirectory);
+}
+
+void FUnrealToUnityExporterDescriptorWriter::WriteJsonRecord(FArchive& Archive, const FString& JsonString)
+{
+	const FTCHARToUTF8 Utf8String(*JsonString);
+	Archive.Serialize(const_cast<ANSICHAR*>(Utf8String.Get()), Utf8String.Length());
+}
+
+void FUnrealToUnityExporterDescriptorWriter::WriteBinaryRecord(const TArray<uint8>& Payload, TArray<uint64>& OutRecordOffsets)
+{
+	OutRecordOffsets.Add(Writer->Tell());
+
+	uint32 PayloadSize = Payload.Num();
+	*Writer << PayloadSize;
+	Writer->Serialize(const_cast<uint8*>(Payload.GetData()), Payload.Num());
+}
+
+void FUnrealToUnityExporterDescriptorWriter::Abort()
+{
+	IFileManager& FileManager = IFileManager::Get();
+
+	Writer.Reset();
+	MeshesWriter.Reset();
+	FileManager.Delete(*TempSavePath, false, false, true /*bQuiet*/);
+	FileManager.Delete(*TempMeshesPath, false, false, true /*bQuiet*/);
+}
+
+void FUnrealToUnityExporterDescriptorWriter::WriteString(FArchive& Archive, const FString& String)
+{
+	const FTCHARToUTF8 Utf8String(*String);
+	uint32 Length = Utf8String.Length();
+	Archive << Length;
+	Archive.Serialize(const_cast<ANSICHAR*>(Utf8String.Get()), Length);
+}
@@ -0,0 +1,72 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "UnrealToUnityExporter.h"
+#include "UnrealToUnityExporterDescriptorWriter.generated.h"
+
+USTRUCT()
+struct FUnrealToUnityExporterImportDescriptorHeader
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString ExportDirectory;
+};
+
+/**
+ * Streams the import descriptor to disk while the export runs instead of building it in memory.
+ *
+ * Json writes ImportDescriptor.txt in the same layout as before, but without indentation. Meshes are
+ * buffered in a side file so they can be appended after the material array.
+ *
+ * Binary writes ImportDescriptor.bin, which can be memory mapped. All values are little endian. A string
+ * is a uint32 byte count followed by that many UTF-8 bytes.
+ *   Header:   char[4] "UTUD", uint32 Version, uint32 MaterialCount, uint32 MeshCount,
+ *             uint64 MaterialOffsetsOffset, uint64 MeshOffsetsOffset, string ExportDirectory
+ *   Records:  uint32 PayloadSize, payload
+ *             Material payload: string MaterialPath, int32 BlendMode, uint32 TextureCount, then per texture
+ *             uint8 Flags (1 UseTexture, 2 UseColor, 4 UseScalar), float[4] Color, float Scalar,
+ *             string ParameterName, string TexturePath, string TextureFormat, then string MaskMapPath, string MaskMapFormat
+ *             Mesh payload: string MeshPath, uint8 bEnableReadWrite
+ *   Offsets:  uint64[MaterialCount] and uint64[MeshCount] file offsets of the records
+ *
+ * Both files are written under a temporary name and only moved into place by Finish.
+ */
+class FUnrealToUnityExporterDescriptorWriter
+{
+public:
+	FUnrealToUnityExporterDescriptorWriter(const FString& InExportDirectory, bool bInIsBinary);
+	~FUnrealToUnityExporterDescriptorWriter();
+
+	bool Open();
+
+	/** Materials are written once per material path */
+	void AddMaterial(const FUnrealToUnityExporterMaterialDescriptor& MaterialDescriptor);
+	void AddMesh(const FUnrealToUnityExporterMeshDescriptor& MeshDescriptor);
+
+	/** Returns the path of the complete descriptor, empty if it couldn't be written */
+	FString Finish();
+
+private:
+	void WriteHeader();
+	void WriteJsonRecord(FArchive& Archive, const FString& JsonString);
+	void WriteBinaryRecord(const TArray<uint8>& Payload, TArray<uint64>& OutRecordOffsets);
+	void Abort();
+
+	static void WriteString(FArchive& Archive, const FString& String);
+
+	static constexpr uint32 BinaryVersion = 3;
+
+	FString ExportDirectory;
+	bool bIsBinary;
+	FString SavePath;
+	FString TempSavePath;
+	FString TempMeshesPath;
+	TUniquePtr<FArchive> Writer;
+	TUniquePtr<FArchive> MeshesWriter;
+	TSet<FString> WrittenMaterialPaths;
+	TArray<uint64> MaterialRecordOffsets;
+	TArray<uint64> MeshRecordOffsets;
+	int32 JsonMeshCount = 0;
+	bool bHasError = false;
+};
@@ -0,0 +1,253 @@
+﻿#include "UnrealToUnityExporterExportCache.h"
+
+#include "JsonObjectConverter.h"
+#include "SExportSettingsWindow.h"
+#include "Algo/RemoveIf.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Materials/MaterialInterface.h"
+#include "Misc/FileHelper.h"
+#include "Misc/SecureHash.h"
+
+FUnrealToUnityExporterExportCache::FUnrealToUnityExporterExportCache(const FString& InExportDirectory, const FExportSettings& ExportSettings)
+	: ExportDirectory(InExportDirectory)
+	, ManifestPath(InExportDirectory / TEXT("ExportCache.json"))
+{
+	Manifest.Version = ManifestVersion;
+	Manifest.SettingsHash = GetExportSettingsHash(ExportSettings);
+}
+
+void FUnrealToUnityExporterExportCache::Load()
+{
+	FString JsonString;
+	if (!FFileHelper::LoadFileToString(JsonString, *ManifestPath))
+	{
+		return;
+	}
+
+	FUnrealToUnityExporterExportCacheManifest LoadedManifest;
+	if (!FJsonObjectConverter::JsonObjectStringToUStruct(JsonString, &LoadedManifest))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Export cache couldn't be parsed, exporting everything: %s"), *ManifestPath);
+		return;
+	}
+
+	// Different settings produce different outputs for every mesh, nothing can be reused
+	if (LoadedManifest.Version != Manifest.Version || LoadedManifest.SettingsHash != Manifest.SettingsHash)
+	{
+		return;
+	}
+
+	Manifest.Entries = MoveTemp(LoadedManifest.Entries);
+}
+
+bool FUnrealToUnityExporterExportCache::Save() const
+{
+	FString JsonString;
+	if (!FJsonObjectConverter::UStructToJsonObjectString(Manifest, JsonString, 0, 0, 0, nullptr, false /*bPrettyPrint*/))
+	{
+		return false;
+	}
+
+	return FFileHelper::SaveStringToFile(JsonString, *ManifestPath);
+}
+
+const FUnrealToUnityExporterExportCacheEntry* FUnrealToUnityExporterExportCache::FindUpToDateEntry(const FAssetData& StaticMeshAsset)
+{
+	const FString MeshPath = StaticMeshAsset.GetObjectPathString();
+
+	FPendingEntry& PendingEntry = PendingEntries.FindOrAdd(MeshPath);
+	PendingEntry.SourceHash = ComputeSourceHash(StaticMeshAsset.PackageName);
+	PendingEntry.OriginalMaterialNames.Reset();
+
+	// Materials the mesh references directly, without loading it
+	for (const FName& Dependency : GetPackageDependencies(StaticMeshAsset.PackageName))
+	{
+		if (IsMaterialPackage(Dependency))
+		{
+			PendingEntry.OriginalMaterialNames.AddUnique(Dependency);
+		}
+	}
+
+	const FUnrealToUnityExporterExportCacheEntry* Entry = Manifest.Entries.Find(MeshPath);
+
+	if (Entry && !PendingEntry.SourceHash.IsEmpty() && Entry->SourceHash == PendingEntry.SourceHash && AreExportedFilesPresent(*Entry))
+	{
+		return Entry;
+	}
+
+	return nullptr;
+}
+
+void FUnrealToUnityExporterExportCache::UpdateEntry(const FString& MeshPath, const FUnrealToUnityExporterMeshDescriptor& MeshDescriptor, const TMap<FName, FUnrealToUnityExporterMaterialDescriptor>& OriginalPathsToMaterialDescriptors)
+{
+	const FPendingEntry* PendingEntry = PendingEntries.Find(MeshPath);
+
+	if (!PendingEntry || PendingEntry->SourceHash.IsEmpty())
+	{
+		Manifest.Entries.Remove(MeshPath);
+		return;
+	}
+
+	FUnrealToUnityExporterExportCacheEntry& Entry = Manifest.Entries.FindOrAdd(MeshPath);
+	Entry.SourceHash = PendingEntry->SourceHash;
+	Entry.MeshDescriptor = MeshDescriptor;
+	Entry.MaterialDescriptors.Reset();
+
+	for (const FName& OriginalMaterialName : PendingEntry->OriginalMaterialNames)
+	{
+		if (const FUnrealToUnityExporterMaterialDescriptor* MaterialDescriptor = OriginalPathsToMaterialDescriptors.Find(OriginalMaterialName))
+		{
+			Entry.MaterialDescriptors.Add(*MaterialDescriptor);
+		}
+	}
+}
+
+FString FUnrealToUnityExporterExportCache::GetExportSettingsHash(const FExportSettings& ExportSettings)
+{
+	// Every setting which changes the exported files has to be part of the hash
+	const FString SettingsString = FString::Printf(TEXT("TextureSize=%d;EnableReadWrite=%d;UniformTexturesAsConstants=%d;UniformTextureTolerance=%d;CompressedTextures=%d;FastBlockCompression=%d;PngCompression=%s;PackMaskMaps=%d;PassThroughMaterials=%d;LodStrategy=%s;MergeEquivalentMaterials=%d"),
+		ExportSettings.TextureSize,
+		ExportSettings.bEnableReadWrite,
+		ExportSettings.bUniformTexturesAsConstants,
+		ExportSettings.UniformTextureTolerance,
+		ExportSettings.bCompressedTextures,
+		ExportSettings.bFastBlockCompression,
+		LexToString(ExportSettings.PngCompression),
+		ExportSettings.bPackMaskMaps,
+		ExportSettings.bPassThroughMaterials,
+		LexToString(ExportSettings.LodStrategy),
+		ExportSettings.bMergeEquivalentMaterials);
+
+	return FMD5::HashAnsiString(*SettingsString);
+}
+
+FString FUnrealToUnityExporterExportCache::ComputeSourceHash(FName PackageName)
+{
+	TSet<FName> VisitedPackages;
+	TArray<FName> PackagesToVisit{ PackageName };
+
+	while (!PackagesToVisit.IsEmpty())
+	{
+		const FName CurrentPackageName = PackagesToVisit.Pop(false);
+
+		if (VisitedPackages.Contains(CurrentPackageName))
+		{
+			continue;
+		}
+
+		VisitedPackages.Add(CurrentPackageName);
+		PackagesToVisit.Append(GetPackageDependencies(CurrentPackageName));
+	}
+
+	TArray<FName> SortedPackages = VisitedPackages.Array();
+	SortedPackages.Sort(FNameLexicalLess());
+
+	FMD5 Md5;
+
+	for (const FName& SortedPackage : SortedPackages)
+	{
+		const FString& PackageHash = GetPackageHash(SortedPackage);
+
+		// Unsaved or unknown packages can't be trusted, always export them
+		if (PackageHash.IsEmpty())
+		{
+			return FString();
+		}
+
+		const FString PackageString = SortedPackage.ToString() + TEXT("=") + PackageHash + TEXT(";");
+		const FTCHARToUTF8 Utf8String(*PackageString);
+		Md5.Update(reinterpret_cast<const uint8*>(Utf8String.Get()), Utf8String.Length());
+	}
+
+	FMD5Hash Hash;
+	Hash.Set(Md5);
+	return LexToString(Hash);
+}
+
+const FString& FUnrealToUnityExporterExportCache::GetPackageHash(FName PackageName)
+{
+	if (const FString* PackageHash = PackageHashes.Find(PackageName))
+	{
+		return *PackageHash;
+	}
+
+	FString& PackageHash = PackageHashes.Add(PackageName);
+
+	const UPackage* LoadedPackage = FindPackage(nullptr, *PackageName.ToString());
+
+	if (LoadedPackage && LoadedPackage->IsDirty())
+	{
+		return PackageHash;
+	}
+
+	const IAssetRegistry& AssetRegistry = FModuleManager::Get().LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	const TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy(PackageName);
+
+	if (PackageData.IsSet())
+	{
+		PackageHash = LexToString(PackageData->GetPackageSavedHash());
+	}
+
+	return PackageHash;
+}
+
+const TArray<FName>& FUnrealToUnityExporterExportCache::GetPackageDependencies(FName PackageName)
+{
+	if (const TArray<FName>* Dependencies = PackageDependencies.Find(PackageName))
+	{
+		return *Dependencies;
+	}
+
+	TArray<FName> Dependencies;
+	const IAssetRegistry& AssetRegistry = FModuleManager::Get().LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.GetDependencies(PackageName, Dependencies, UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Hard);
+
+	// Script packages only change together with the engine/project binaries
+	Dependencies.SetNum(Algo::RemoveIf(Dependencies, [] (const FName& Dependency)
+	{
+		return FPackageName::IsScriptPackage(Dependency.ToString());
+	}));
+
+	return PackageDependencies.Add(PackageName, MoveTemp(Dependencies));
+}
+
+bool FUnrealToUnityExporterExportCache::IsMaterialPackage(FName PackageName) const
+{
+	const IAssetRegistry& AssetRegistry = FModuleManager::Get().LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssetsByPackageName(PackageName, Assets, true /*bIncludeOnlyOnDiskAssets*/);
+
+	return Assets.ContainsByPredicate([] (const FAssetData& AssetData)
+	{
+		return AssetData.IsInstanceOf(UMaterialInterface::StaticClass());
+	});
+}
+
+bool FUnrealToUnityExporterExportCache::AreExportedFilesPresent(const FUnrealToUnityExporterExportCacheEntry& Entry) const
+{
+	IFileManager& FileManager = IFileManager::Get();
+
+	if (!FileManager.FileExists(*(ExportDirectory / Entry.MeshDescriptor.MeshPath)))
+	{
+		return false;
+	}
+
+	for (const FUnrealToUnityExporterMaterialDescriptor& MaterialDescriptor : Entry.MaterialDescriptors)
+	{
+		if (!MaterialDescriptor.MaskMapPath.IsEmpty() && !FileManager.FileExists(*(ExportDirectory / MaterialDescriptor.MaskMapPath)))
+		{
+			return false;
+		}
+
+		for (const FUnrealToUnityExporterTextureDescriptor& TextureDescriptor : MaterialDescriptor.TextureDescriptors)
+		{
+			if (!TextureDescriptor.TexturePath.IsEmpty() && !FileManager.FileExists(*(ExportDirectory / TextureDescriptor.TexturePath)))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,85 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "UnrealToUnityExporter.h"
+#include "UnrealToUnityExporterExportCache.generated.h"
+
+struct FExportSettings;
+
+USTRUCT()
+struct FUnrealToUnityExporterExportCacheEntry
+{
+	GENERATED_BODY()
+
+	/** Hash of the mesh package and every package it depends on (materials, textures, ...) */
+	UPROPERTY()
+	FString SourceHash;
+
+	UPROPERTY()
+	FUnrealToUnityExporterMeshDescriptor MeshDescriptor;
+
+	UPROPERTY()
+	TArray<FUnrealToUnityExporterMaterialDescriptor> MaterialDescriptors;
+};
+
+USTRUCT()
+struct FUnrealToUnityExporterExportCacheManifest
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Version = 0;
+
+	UPROPERTY()
+	FString SettingsHash;
+
+	/** Keyed by mesh object path */
+	UPROPERTY()
+	TMap<FString, FUnrealToUnityExporterExportCacheEntry> Entries;
+};
+
+/**
+ * Persistent manifest stored in the export directory which remembers what every mesh was exported from.
+ * Meshes whose source packages, referenced materials/textures and export settings did not change since the
+ * last run can be skipped entirely and their previous descriptors carried over.
+ */
+class FUnrealToUnityExporterExportCache
+{
+public:
+	FUnrealToUnityExporterExportCache(const FString& InExportDirectory, const FExportSettings& ExportSettings);
+
+	void Load();
+	bool Save() const;
+
+	/** Returns the cached entry if the mesh is unchanged and its exported files are still on disk, only asset registry data is used */
+	const FUnrealToUnityExporterExportCacheEntry* FindUpToDateEntry(const FAssetData& StaticMeshAsset);
+
+	/** Must be called after FindUpToDateEntry for the same mesh */
+	void UpdateEntry(const FString& MeshPath, const FUnrealToUnityExporterMeshDescriptor& MeshDescriptor, const TMap<FName, FUnrealToUnityExporterMaterialDescriptor>& OriginalPathsToMaterialDescriptors);
+
+	static FString GetExportSettingsHash(const FExportSettings& ExportSettings);
+
+	/** Hash of the package and everything it depends on, empty if any of them isn't saved */
+	FString ComputeSourceHash(FName PackageName);
+
+private:
+	const FString& GetPackageHash(FName PackageName);
+	const TArray<FName>& GetPackageDependencies(FName PackageName);
+	bool AreExportedFilesPresent(const FUnrealToUnityExporterExportCacheEntry& Entry) const;
+	bool IsMaterialPackage(FName PackageName) const;
+
+	struct FPendingEntry
+	{
+		FString SourceHash;
+		TArray<FName> OriginalMaterialNames;
+	};
+
+	static constexpr int32 ManifestVersion = 1;
+
+	FString ExportDirectory;
+	FString ManifestPath;
+	FUnrealToUnityExporterExportCacheManifest Manifest;
+	TMap<FString, FPendingEntry> PendingEntries;
+	TMap<FName, FString> PackageHashes;
+	TMap<FName, TArray<FName>> PackageDependencies;
+};
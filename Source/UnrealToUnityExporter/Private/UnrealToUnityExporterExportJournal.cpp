@@ -0,0 +1,159 @@
+﻿#include "UnrealToUnityExporterExportJournal.h"
+
+#include "JsonObjectConverter.h"
+#include "Misc/FileHelper.h"
+
+FUnrealToUnityExporterExportJournal::FUnrealToUnityExporterExportJournal(const FString& ExportDirectory, const FString& InSettingsHash)
+	: JournalPath(ExportDirectory / TEXT("ExportJournal.jsonl"))
+	, SettingsHash(InSettingsHash)
+{
+}
+
+FUnrealToUnityExporterExportJournal::~FUnrealToUnityExporterExportJournal()
+{
+	Flush();
+}
+
+void FUnrealToUnityExporterExportJournal::Load()
+{
+	CompletedMeshes.Reset();
+	CompletedMaterials.Reset();
+	
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *JournalPath) || Lines.IsEmpty())
+	{
+		return;
+	}
+
+	FUnrealToUnityExporterExportJournalRecord HeaderRecord;
+	if (!FJsonObjectConverter::JsonObjectStringToUStruct(Lines[0], &HeaderRecord) || HeaderRecord.SettingsHash != SettingsHash)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Export journal was written with different settings, starting from the beginning: %s"), *JournalPath);
+		return;
+	}
+
+	for (int32 LineIndex = 1; LineIndex < Lines.Num(); LineIndex++)
+	{
+		FUnrealToUnityExporterExportJournalRecord Record;
+
+		// Last line may be cut off if the editor went down while writing it
+		if (!FJsonObjectConverter::JsonObjectStringToUStruct(Lines[LineIndex], &Record))
+		{
+			continue;
+		}
+
+		if (!Record.MeshObjectPath.IsEmpty())
+		{
+			CompletedMeshes.Add(Record.MeshObjectPath, MoveTemp(Record.MeshDescriptor));
+		}
+		else if (!Record.OriginalMaterialPath.IsEmpty())
+		{
+			CompletedMaterials.Add(FName(Record.OriginalMaterialPath), MoveTemp(Record.MaterialDescriptor));
+		}
+	}
+}
+
+bool FUnrealToUnityExporterExportJournal::Open(bool bResume)
+{
+	if (!bResume)
+	{
+		CompletedMeshes.Reset();
+		CompletedMaterials.Reset();
+	}
+
+	// Rewritten from the loaded records, which drops a partially written last line
+	Writer.Reset(IFileManager::Get().CreateFileWriter(*JournalPath));
+
+	if (!Writer)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Export journal couldn't be opened: %s"), *JournalPath);
+		return false;
+	}
+
+	FUnrealToUnityExporterExportJournalRecord HeaderRecord;
+	HeaderRecord.SettingsHash = SettingsHash;
+	WriteRecord(HeaderRecord);
+
+	for (const auto& [OriginalMaterialPath, MaterialDescriptor] : CompletedMaterials)
+	{
+		FUnrealToUnityExporterExportJournalRecord Record;
+		Record.OriginalMaterialPath = OriginalMaterialPath.ToString();
+		Record.MaterialDescriptor = MaterialDescriptor;
+		WriteRecord(Record);
+	}
+
+	for (const auto& [MeshObjectPath, MeshDescriptor] : CompletedMeshes)
+	{
+		FUnrealToUnityExporterExportJournalRecord Record;
+		Record.MeshObjectPath = MeshObjectPath;
+		Record.MeshDescriptor = MeshDescriptor;
+		WriteRecord(Record);
+	}
+
+	Flush();
+	return true;
+}
+
+void FUnrealToUnityExporterExportJournal::AddMesh(const FString& MeshObjectPath, const FUnrealToUnityExporterMeshDescriptor& MeshDescriptor)
+{
+	FUnrealToUnityExporterExportJournalRecord Record;
+	Record.MeshObjectPath = MeshObjectPath;
+	Record.MeshDescriptor = MeshDescriptor;
+	WriteRecord(Record);
+
+	CompletedMeshes.Add(MeshObjectPath, MeshDescriptor);
+}
+
+void FUnrealToUnityExporterExportJournal::AddMaterial(FName OriginalMaterialPath, const FUnrealToUnityExporterMaterialDescriptor& MaterialDescriptor)
+{
+	FUnrealToUnityExporterExportJournalRecord Record;
+	Record.OriginalMaterialPath = OriginalMaterialPath.ToString();
+	Record.MaterialDescriptor = MaterialDescriptor;
+	WriteRecord(Record);
+
+	CompletedMaterials.Add(OriginalMaterialPath, MaterialDescriptor);
+}
+
+void FUnrealToUnityExporterExportJournal::Flush()
+{
+	if (Writer)
+	{
+		Writer->Flush();
+	}
+}
+
+void FUnrealToUnityExporterExportJournal::Finish()
+{
+	if (Writer)
+	{
+		Writer->Close();
+		Writer.Reset();
+	}
+
+	IFileManager::Get().Delete(*JournalPath);
+}
+
+const TMap<FString, FUnrealToUnityExporterMeshDescriptor>& FUnrealToUnityExporterExportJournal::GetCompletedMeshes() const
+{
+	return CompletedMeshes;
+}
+
+const TMap<FName, FUnrealToUnityExporterMaterialDescriptor>& FUnrealToUnityExporterExportJournal::GetCompletedMaterials() const
+{
+	return CompletedMaterials;
+}
+
+void FUnrealToUnityExporterExportJournal::WriteRecord(const FUnrealToUnityExporterExportJournalRecord& Record)
+{
+	if (!Writer)
+	{
+		return;
+	}
+
+	FString JsonString;
+	FJsonObjectConverter::UStructToJsonObjectString(Record, JsonString, 0, 0, 0, nullptr, false /*bPrettyPrint*/);
+	JsonString += TEXT("\n");
+
+	const FTCHARToUTF8 Utf8String(*JsonString);
+	Writer->Serialize(const_cast<ANSICHAR*>(Utf8String.Get()), Utf8String.Length());
+}
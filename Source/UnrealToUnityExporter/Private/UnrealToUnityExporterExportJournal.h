@@ -0,0 +1,68 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "UnrealToUnityExporter.h"
+#include "UnrealToUnityExporterExportJournal.generated.h"
+
+USTRUCT()
+struct FUnrealToUnityExporterExportJournalRecord
+{
+	GENERATED_BODY()
+
+	/** Set on the first record only */
+	UPROPERTY()
+	FString SettingsHash;
+
+	/** Mesh object path, set for mesh records */
+	UPROPERTY()
+	FString MeshObjectPath;
+
+	UPROPERTY()
+	FUnrealToUnityExporterMeshDescriptor MeshDescriptor;
+
+	/** Original material package name, set for material records */
+	UPROPERTY()
+	FString OriginalMaterialPath;
+
+	UPROPERTY()
+	FUnrealToUnityExporterMaterialDescriptor MaterialDescriptor;
+};
+
+/**
+ * Append-only progress journal in the export directory, one JSON record per line.
+ * Every mesh and material is recorded once its files are on disk, so an interrupted export can be resumed
+ * from the last completed batch. The journal is removed when the export finishes without errors.
+ */
+class FUnrealToUnityExporterExportJournal
+{
+public:
+	FUnrealToUnityExporterExportJournal(const FString& ExportDirectory, const FString& InSettingsHash);
+	~FUnrealToUnityExporterExportJournal();
+
+	/** Reads the records of an interrupted export done with the same settings */
+	void Load();
+
+	/** Starts recording, keeping loaded records when resuming */
+	bool Open(bool bResume);
+
+	void AddMesh(const FString& MeshObjectPath, const FUnrealToUnityExporterMeshDescriptor& MeshDescriptor);
+	void AddMaterial(FName OriginalMaterialPath, const FUnrealToUnityExporterMaterialDescriptor& MaterialDescriptor);
+
+	/** Makes everything recorded so far durable */
+	void Flush();
+
+	/** Removes the journal, only called after a complete export so a failed one can still be resumed */
+	void Finish();
+
+	const TMap<FString, FUnrealToUnityExporterMeshDescriptor>& GetCompletedMeshes() const;
+	const TMap<FName, FUnrealToUnityExporterMaterialDescriptor>& GetCompletedMaterials() const;
+
+private:
+	void WriteRecord(const FUnrealToUnityExporterExportJournalRecord& Record);
+
+	FString JournalPath;
+	FString SettingsHash;
+	TUniquePtr<FArchive> Writer;
+	TMap<FString, FUnrealToUnityExporterMeshDescriptor> CompletedMeshes;
+	TMap<FName, FUnrealToUnityExporterMaterialDescriptor> CompletedMaterials;
+};
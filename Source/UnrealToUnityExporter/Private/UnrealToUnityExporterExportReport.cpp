@@ -0,0 +1,30 @@
+﻿#include "UnrealToUnityExporterExportReport.h"
+
+#include "JsonObjectConverter.h"
+#include "Misc/FileHelper.h"
+
+FUnrealToUnityExporterExportReportAsset& FUnrealToUnityExporterExportReport::FindOrAddAsset(const FString& AssetPath, const TCHAR* AssetType)
+{
+	if (const int32* AssetIndex = AssetPathsToIndices.Find(AssetPath))
+	{
+		return Data.Assets[*AssetIndex];
+	}
+
+	AssetPathsToIndices.Add(AssetPath, Data.Assets.Num());
+
+	FUnrealToUnityExporterExportReportAsset& Asset = Data.Assets.AddDefaulted_GetRef();
+	Asset.AssetPath = AssetPath;
+	Asset.AssetType = AssetType;
+	return Asset;
+}
+
+bool FUnrealToUnityExporterExportReport::Save(const FString& ExportDirectory) const
+{
+	FString JsonString;
+	if (!FJsonObjectConverter::UStructToJsonObjectString(Data, JsonString))
+	{
+		return false;
+	}
+
+	return FFileHelper::SaveStringToFile(JsonString, *(ExportDirectory / TEXT("ExportReport.json")), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
@@ -0,0 +1,122 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "UnrealToUnityExporterExportReport.generated.h"
+
+USTRUCT()
+struct FUnrealToUnityExporterExportReportAsset
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString AssetPath;
+
+	/** Mesh or Material */
+	UPROPERTY()
+	FString AssetType;
+
+	UPROPERTY()
+	double BakeSeconds = 0.0;
+
+	/** FBX export for meshes, mip extraction for materials */
+	UPROPERTY()
+	double ExportSeconds = 0.0;
+
+	/** Shared textures count towards every material using them */
+	UPROPERTY()
+	int64 BytesWritten = 0;
+
+	UPROPERTY()
+	int32 TextureCount = 0;
+};
+
+USTRUCT()
+struct FUnrealToUnityExporterExportReportData
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	double TotalSeconds = 0.0;
+
+	/** Only the time spent waiting, meshes loaded ahead of their batch don't count */
+	UPROPERTY()
+	double LoadSeconds = 0.0;
+
+	UPROPERTY()
+	double BakeSeconds = 0.0;
+
+	UPROPERTY()
+	double MeshExportSeconds = 0.0;
+
+	UPROPERTY()
+	double MipFetchSeconds = 0.0;
+
+	/** Summed over the texture writer tasks, which run in parallel with everything else */
+	UPROPERTY()
+	double EncodeSeconds = 0.0;
+
+	/** Summed over the texture writer tasks, which run in parallel with everything else */
+	UPROPERTY()
+	double WriteSeconds = 0.0;
+
+	UPROPERTY()
+	double DescriptorSaveSeconds = 0.0;
+
+	UPROPERTY()
+	double NotifySeconds = 0.0;
+
+	UPROPERTY()
+	int64 BytesWritten = 0;
+
+	/** Part of BytesWritten, encoded texture files only */
+	UPROPERTY()
+	int64 TextureBytesWritten = 0;
+
+	/** Meshes which failed to load, bake or export aren't counted */
+	UPROPERTY()
+	int32 ExportedMeshCount = 0;
+
+	UPROPERTY()
+	int32 CachedMeshCount = 0;
+
+	UPROPERTY()
+	int32 ResumedMeshCount = 0;
+
+	UPROPERTY()
+	int32 ExportedMaterialCount = 0;
+
+	/** Materials sharing the baked material of an equivalent one, not part of ExportedMaterialCount */
+	UPROPERTY()
+	int32 MergedMaterialCount = 0;
+
+	/** Material bakes fetched from the derived data cache instead of being rendered */
+	UPROPERTY()
+	int32 CachedBakeCount = 0;
+
+	UPROPERTY()
+	int32 WrittenTextureCount = 0;
+
+	/** Textures whose content was already written by this or an earlier export */
+	UPROPERTY()
+	int32 ReusedTextureCount = 0;
+
+	UPROPERTY()
+	TArray<FUnrealToUnityExporterExportReportAsset> Assets;
+};
+
+/**
+ * Collects where the time of an export went and writes it as ExportReport.json into the export directory.
+ * The same phases and assets are visible as named CPU scopes in Unreal Insights.
+ */
+class FUnrealToUnityExporterExportReport
+{
+public:
+	FUnrealToUnityExporterExportReportData Data;
+
+	FUnrealToUnityExporterExportReportAsset& FindOrAddAsset(const FString& AssetPath, const TCHAR* AssetType);
+
+	bool Save(const FString& ExportDirectory) const;
+
+private:
+	TMap<FString, int32> AssetPathsToIndices;
+};
@@ -0,0 +1,170 @@
+﻿#include "UnrealToUnityExporterFbxWorkerCommandlet.h"
+
+#include "AssetExportTask.h"
+#include "JsonObjectConverter.h"
+#include "UnrealToUnityExporterFbxWorkers.h"
+#include "Engine/StaticMesh.h"
+#include "Exporters/Exporter.h"
+#include "Exporters/FbxExportOption.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialInstanceConstant.h"
+#include "Misc/FileHelper.h"
+
+namespace
+{
+	const TCHAR* WorkerPackageRoot = TEXT("/Temp/UnrealToUnityExporterFbxWorker");
+
+	/** Same name as the baked material in the editor process, which is all the FBX file keeps of it */
+	UMaterialInterface* FindOrCreatePlaceholderMaterial(const FString& MaterialName, TMap<FString, UMaterialInterface*>& PlaceholderMaterials)
+	{
+		if (UMaterialInterface** PlaceholderMaterial = PlaceholderMaterials.Find(MaterialName))
+		{
+			return *PlaceholderMaterial;
+		}
+
+		UPackage* Package = CreatePackage(*(FString(WorkerPackageRoot) / TEXT("Materials") / MaterialName));
+		Package->SetFlags(RF_Transient);
+
+		UMaterialInstanceConstant* PlaceholderMaterial = NewObject<UMaterialInstanceConstant>(Package, *MaterialName, RF_Transient);
+		PlaceholderMaterial->SetParentEditorOnly(UMaterial::GetDefaultMaterial(MD_Surface));
+		return PlaceholderMaterials.Add(MaterialName, PlaceholderMaterial);
+	}
+
+	FUnrealToUnityExporterFbxWorkerResult ExportMesh(const FUnrealToUnityExporterFbxWorkerMesh& Mesh, UFbxExportOption* FbxExportOption, TMap<FString, UMaterialInterface*>& PlaceholderMaterials)
+	{
+		FUnrealToUnityExporterFbxWorkerResult Result;
+		const double StartSeconds = FPlatformTime::Seconds();
+
+		UStaticMesh* SourceStaticMesh = LoadObject<UStaticMesh>(nullptr, *Mesh.SourceMeshPath);
+
+		if (!SourceStaticMesh)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Mesh couldn't be loaded: %s"), *Mesh.SourceMeshPath);
+			return Result;
+		}
+
+		// Same duplicate as the editor process exports, with its own package so equally named meshes don't collide
+		UPackage* Package = CreatePackage(*(FString(WorkerPackageRoot) + SourceStaticMesh->GetPackage()->GetName()));
+		Package->SetFlags(RF_Transient);
+
+		UStaticMesh* StaticMesh = DuplicateObject<UStaticMesh>(SourceStaticMesh, Package, SourceStaticMesh->GetFName());
+		StaticMesh->ClearFlags(RF_Public | RF_Standalone);
+		StaticMesh->SetFlags(RF_Transient);
+
+		if (!StaticMesh->GetRenderData() || !StaticMesh->GetRenderData()->IsInitialized())
+		{
+			StaticMesh->Build(true);
+		}
+
+		TArray<FStaticMaterial>& StaticMaterials = StaticMesh->GetStaticMaterials();
+
+		for (int32 MaterialIndex = 0; MaterialIndex < StaticMaterials.Num() && MaterialIndex < Mesh.MaterialNames.Num(); MaterialIndex++)
+		{
+			if (!Mesh.MaterialNames[MaterialIndex].IsEmpty())
+			{
+				StaticMaterials[MaterialIndex].MaterialInterface = FindOrCreatePlaceholderMaterial(Mesh.MaterialNames[MaterialIndex], PlaceholderMaterials);
+			}
+		}
+
+		UAssetExportTask* ExportTask = NewObject<UAssetExportTask>();
+		ExportTask->Object = StaticMesh;
+		ExportTask->Filename = Mesh.Filename;
+		ExportTask->bSelected = false;
+		ExportTask->bReplaceIdentical = true;
+		ExportTask->bPrompt = false;
+		ExportTask->bAutomated = true;
+		FbxExportOption->LevelOfDetail = Mesh.bExportLods;
+		ExportTask->Options = FbxExportOption;
+
+		Result.bIsExported = UExporter::RunAssetExportTask(ExportTask);
+
+		if (Result.bIsExported)
+		{
+			Result.BytesWritten = FMath::Max<int64>(IFileManager::Get().FileSize(*Mesh.Filename), 0);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("Mesh couldn't be exported: %s"), *Mesh.SourceMeshPath);
+		}
+
+		Result.ExportSeconds = FPlatformTime::Seconds() - StartSeconds;
+		return Result;
+	}
+}
+
+UUnrealToUnityExporterFbxWorkerCommandlet::UUnrealToUnityExporterFbxWorkerCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UUnrealToUnityExporterFbxWorkerCommandlet::Main(const FString& Params)
+{
+	FString WorkingDirectory;
+	int32 WorkerIndex = INDEX_NONE;
+	uint32 ParentProcessId = 0;
+
+	if (!FParse::Value(*Params, TEXT("WorkingDirectory="), WorkingDirectory) || !FParse::Value(*Params, TEXT("WorkerIndex="), WorkerIndex))
+	{
+		UE_LOG(LogTemp, Error, TEXT("FBX worker needs -WorkingDirectory= and -WorkerIndex="));
+		return 1;
+	}
+
+	FParse::Value(*Params, TEXT("ParentProcessId="), ParentProcessId);
+
+	UFbxExportOption* FbxExportOption = NewObject<UFbxExportOption>();
+	FbxExportOption->LoadOptions();
+
+	for (int32 ShardIndex = 0; ; )
+	{
+		const FString ShardPath = FUnrealToUnityExporterFbxWorkers::GetShardPath(WorkingDirectory, WorkerIndex, ShardIndex);
+
+		if (!IFileManager::Get().FileExists(*ShardPath))
+		{
+			if (IFileManager::Get().FileExists(*FUnrealToUnityExporterFbxWorkers::GetShutdownPath(WorkingDirectory))
+				|| (ParentProcessId != 0 && !FPlatformProcess::IsApplicationRunning(ParentProcessId)))
+			{
+				break;
+			}
+
+			FPlatformProcess::Sleep(0.05f);
+			continue;
+		}
+
+		FString ShardString;
+		FUnrealToUnityExporterFbxWorkerShard Shard;
+
+		if (!FFileHelper::LoadFileToString(ShardString, *ShardPath) || !FJsonObjectConverter::JsonObjectStringToUStruct(ShardString, &Shard))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Shard couldn't be read: %s"), *ShardPath);
+		}
+
+		FUnrealToUnityExporterFbxWorkerShardResult ShardResult;
+		TMap<FString, UMaterialInterface*> PlaceholderMaterials;
+
+		for (const FUnrealToUnityExporterFbxWorkerMesh& Mesh : Shard.Meshes)
+		{
+			ShardResult.Results.Add(ExportMesh(Mesh, FbxExportOption, PlaceholderMaterials));
+		}
+
+		IFileManager::Get().Delete(*ShardPath);
+
+		const FString ResultPath = FUnrealToUnityExporterFbxWorkers::GetResultPath(WorkingDirectory, WorkerIndex, ShardIndex);
+		const FString TemporaryResultPath = ResultPath + TEXT(".tmp");
+		FString ResultString;
+		FJsonObjectConverter::UStructToJsonObjectString(ShardResult, ResultString, 0, 0, 0, nullptr, false /*bPrettyPrint*/);
+
+		if (!FFileHelper::SaveStringToFile(ResultString, *TemporaryResultPath) || !IFileManager::Get().Move(*ResultPath, *TemporaryResultPath))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Shard result couldn't be written: %s"), *ResultPath);
+		}
+
+		// Loaded meshes and placeholders of the shard aren't needed anymore
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		ShardIndex++;
+	}
+
+	return 0;
+}
@@ -0,0 +1,23 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UnrealToUnityExporterFbxWorkerCommandlet.generated.h"
+
+/**
+ * FBX export worker launched by FUnrealToUnityExporterFbxWorkers, not meant to be run by hand:
+ *
+ * UnrealEditor <Project> -run=UnrealToUnityExporterFbxWorker -WorkingDirectory=<Path> -WorkerIndex=<Index> -ParentProcessId=<Id>
+ *
+ * Exports the meshes of every shard file written for it until the shutdown file appears or the parent process is gone.
+ */
+UCLASS()
+class UUnrealToUnityExporterFbxWorkerCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UUnrealToUnityExporterFbxWorkerCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
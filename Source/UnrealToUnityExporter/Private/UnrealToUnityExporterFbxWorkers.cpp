@@ -0,0 +1,234 @@
+﻿#include "UnrealToUnityExporterFbxWorkers.h"
+
+#include "JsonObjectConverter.h"
+#include "Misc/FileHelper.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+FUnrealToUnityExporterFbxWorkers::FUnrealToUnityExporterFbxWorkers(const FString& InWorkingDirectory, int32 InProcessCount)
+	: WorkingDirectory(InWorkingDirectory)
+	, ProcessCount(InProcessCount)
+{
+}
+
+FUnrealToUnityExporterFbxWorkers::~FUnrealToUnityExporterFbxWorkers()
+{
+	ShutdownWorkers();
+}
+
+void FUnrealToUnityExporterFbxWorkers::Export(TConstArrayView<FUnrealToUnityExporterFbxWorkerMesh> Meshes, TArray<FUnrealToUnityExporterFbxWorkerResult>& OutResults)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_FbxWorkers);
+
+	OutResults.Reset();
+	OutResults.SetNum(Meshes.Num());
+
+	if (ProcessCount < 2 || Meshes.Num() < MinMeshesPerWorker * 2 || !LaunchWorkers())
+	{
+		return;
+	}
+
+	TArray<int32> WorkerIndices;
+
+	for (int32 WorkerIndex = 0; WorkerIndex < ProcessHandles.Num(); WorkerIndex++)
+	{
+		if (ProcessHandles[WorkerIndex].IsValid())
+		{
+			WorkerIndices.Add(WorkerIndex);
+		}
+	}
+
+	if (WorkerIndices.IsEmpty())
+	{
+		return;
+	}
+
+	const int32 ShardIndex = NextShardIndex++;
+	const int32 MeshesPerWorker = FMath::DivideAndRoundUp(Meshes.Num(), WorkerIndices.Num());
+	const double TimeoutSeconds = FPlatformTime::Seconds() + MinShardTimeoutSeconds + ShardTimeoutSecondsPerMesh * MeshesPerWorker;
+
+	TArray<bool> AreWorkersDone;
+	AreWorkersDone.Init(true, ProcessHandles.Num());
+	int32 DoneWorkerCount = ProcessHandles.Num() - WorkerIndices.Num();
+
+	auto GetFirstMeshIndex = [&WorkerIndices, &Meshes, MeshesPerWorker] (int32 WorkerIndex)
+	{
+		return FMath::Min(WorkerIndices.IndexOfByKey(WorkerIndex) * MeshesPerWorker, Meshes.Num());
+	};
+
+	// Every running worker gets a shard, even an empty one, so shard numbers stay in step
+	for (const int32 WorkerIndex : WorkerIndices)
+	{
+		FUnrealToUnityExporterFbxWorkerShard Shard;
+		const int32 FirstMeshIndex = GetFirstMeshIndex(WorkerIndex);
+		Shard.Meshes.Append(Meshes.Slice(FirstMeshIndex, FMath::Min(MeshesPerWorker, Meshes.Num() - FirstMeshIndex)));
+
+		// Moved into place so a worker never reads a partially written shard
+		const FString ShardPath = GetShardPath(WorkingDirectory, WorkerIndex, ShardIndex);
+		const FString TemporaryShardPath = ShardPath + TEXT(".tmp");
+		FString ShardString;
+
+		if (!FJsonObjectConverter::UStructToJsonObjectString(Shard, ShardString, 0, 0, 0, nullptr, false /*bPrettyPrint*/)
+			|| !FFileHelper::SaveStringToFile(ShardString, *TemporaryShardPath)
+			|| !IFileManager::Get().Move(*ShardPath, *TemporaryShardPath))
+		{
+			// The worker would wait for this shard forever and never pick up later ones
+			UE_LOG(LogTemp, Warning, TEXT("FBX worker shard couldn't be written, its meshes are exported in the editor: %s"), *ShardPath);
+			TerminateWorker(WorkerIndex);
+			DoneWorkerCount++;
+			continue;
+		}
+
+		AreWorkersDone[WorkerIndex] = false;
+	}
+
+	while (DoneWorkerCount < ProcessHandles.Num())
+	{
+		for (int32 WorkerIndex = 0; WorkerIndex < ProcessHandles.Num(); WorkerIndex++)
+		{
+			if (AreWorkersDone[WorkerIndex])
+			{
+				continue;
+			}
+
+			const FString ResultPath = GetResultPath(WorkingDirectory, WorkerIndex, ShardIndex);
+			const bool bIsRunning = FPlatformProcess::IsProcRunning(ProcessHandles[WorkerIndex]);
+
+			// Result is checked after the process state, a worker may write it right before exiting
+			if (IFileManager::Get().FileExists(*ResultPath))
+			{
+				FString ResultString;
+				FUnrealToUnityExporterFbxWorkerShardResult ShardResult;
+				const int32 FirstMeshIndex = GetFirstMeshIndex(WorkerIndex);
+
+				if (FFileHelper::LoadFileToString(ResultString, *ResultPath) && FJsonObjectConverter::JsonObjectStringToUStruct(ResultString, &ShardResult))
+				{
+					for (int32 ResultIndex = 0; ResultIndex < ShardResult.Results.Num() && FirstMeshIndex + ResultIndex < Meshes.Num(); ResultIndex++)
+					{
+						OutResults[FirstMeshIndex + ResultIndex] = ShardResult.Results[ResultIndex];
+					}
+				}
+
+				IFileManager::Get().Delete(*ResultPath);
+				AreWorkersDone[WorkerIndex] = true;
+				DoneWorkerCount++;
+			}
+			else if (!bIsRunning)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("FBX worker %d exited without a result, its meshes are exported in the editor"), WorkerIndex);
+				TerminateWorker(WorkerIndex);
+				AreWorkersDone[WorkerIndex] = true;
+				DoneWorkerCount++;
+			}
+			else if (FPlatformTime::Seconds() > TimeoutSeconds)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("FBX worker %d stopped answering and was terminated, its meshes are exported in the editor"), WorkerIndex);
+				TerminateWorker(WorkerIndex);
+				AreWorkersDone[WorkerIndex] = true;
+				DoneWorkerCount++;
+			}
+		}
+
+		if (DoneWorkerCount < ProcessHandles.Num())
+		{
+			FPlatformProcess::Sleep(0.05f);
+		}
+	}
+}
+
+bool FUnrealToUnityExporterFbxWorkers::LaunchWorkers()
+{
+	if (!ProcessHandles.IsEmpty() || bIsLaunchFailed)
+	{
+		return !bIsLaunchFailed;
+	}
+
+	IFileManager::Get().DeleteDirectory(*WorkingDirectory, false, true);
+	IFileManager::Get().MakeDirectory(*WorkingDirectory, true);
+
+	const FString ExecutablePath = FPlatformProcess::ExecutablePath();
+	const FString ProjectPath = FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath());
+	const FString FullWorkingDirectory = FPaths::ConvertRelativePathToFull(WorkingDirectory);
+
+	for (int32 WorkerIndex = 0; WorkerIndex < ProcessCount; WorkerIndex++)
+	{
+		// Exporting only reads the CPU copy of the render data, workers don't need a GPU
+		const FString Arguments = FString::Printf(TEXT("\"%s\" -run=UnrealToUnityExporterFbxWorker -WorkingDirectory=\"%s\" -WorkerIndex=%d -ParentProcessId=%u -unattended -nullrhi -nosplash -nopause -nosound"),
+			*ProjectPath, *FullWorkingDirectory, WorkerIndex, FPlatformProcess::GetCurrentProcessId());
+
+		FProcHandle ProcessHandle = FPlatformProcess::CreateProc(*ExecutablePath, *Arguments, true /*bLaunchDetached*/, true /*bLaunchHidden*/, true /*bLaunchReallyHidden*/, nullptr, 0, nullptr, nullptr);
+
+		if (!ProcessHandle.IsValid())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("FBX worker couldn't be launched, meshes are exported in the editor: %s %s"), *ExecutablePath, *Arguments);
+			break;
+		}
+
+		ProcessHandles.Add(ProcessHandle);
+	}
+
+	bIsLaunchFailed = ProcessHandles.IsEmpty();
+	return !bIsLaunchFailed;
+}
+
+void FUnrealToUnityExporterFbxWorkers::ShutdownWorkers()
+{
+	if (ProcessHandles.IsEmpty())
+	{
+		return;
+	}
+
+	FFileHelper::SaveStringToFile(FString(), *GetShutdownPath(WorkingDirectory));
+
+	const double TimeoutSeconds = FPlatformTime::Seconds() + 10.0;
+
+	for (FProcHandle& ProcessHandle : ProcessHandles)
+	{
+		if (!ProcessHandle.IsValid())
+		{
+			continue;
+		}
+
+		while (FPlatformProcess::IsProcRunning(ProcessHandle) && FPlatformTime::Seconds() < TimeoutSeconds)
+		{
+			FPlatformProcess::Sleep(0.05f);
+		}
+
+		if (FPlatformProcess::IsProcRunning(ProcessHandle))
+		{
+			FPlatformProcess::TerminateProc(ProcessHandle, true /*KillTree*/);
+		}
+
+		FPlatformProcess::CloseProc(ProcessHandle);
+	}
+
+	ProcessHandles.Empty();
+	IFileManager::Get().DeleteDirectory(*WorkingDirectory, false, true);
+}
+
+void FUnrealToUnityExporterFbxWorkers::TerminateWorker(int32 WorkerIndex)
+{
+	FProcHandle& ProcessHandle = ProcessHandles[WorkerIndex];
+
+	if (FPlatformProcess::IsProcRunning(ProcessHandle))
+	{
+		FPlatformProcess::TerminateProc(ProcessHandle, true /*KillTree*/);
+	}
+
+	FPlatformProcess::CloseProc(ProcessHandle);
+	ProcessHandle = FProcHandle();
+}
+
+FString FUnrealToUnityExporterFbxWorkers::GetShardPath(const FString& WorkingDirectory, int32 WorkerIndex, int32 ShardIndex)
+{
+	return WorkingDirectory / FString::Printf(TEXT("Worker%d_Shard%d.json"), WorkerIndex, ShardIndex);
+}
+
+FString FUnrealToUnityExporterFbxWorkers::GetResultPath(const FString& WorkingDirectory, int32 WorkerIndex, int32 ShardIndex)
+{
+	return WorkingDirectory / FString::Printf(TEXT("Worker%d_Shard%d.Result.json"), WorkerIndex, ShardIndex);
+}
+
+FString FUnrealToUnityExporterFbxWorkers::GetShutdownPath(const FString& WorkingDirectory)
+{
+	return WorkingDirectory / TEXT("Shutdown");
+}
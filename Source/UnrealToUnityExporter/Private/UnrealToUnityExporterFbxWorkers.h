@@ -0,0 +1,99 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "UnrealToUnityExporterFbxWorkers.generated.h"
+
+USTRUCT()
+struct FUnrealToUnityExporterFbxWorkerMesh
+{
+	GENERATED_BODY()
+
+	/** Object path of the saved source mesh, the worker loads it from disk */
+	UPROPERTY()
+	FString SourceMeshPath;
+
+	UPROPERTY()
+	FString Filename;
+
+	/** Baked material name of every material slot, FBX files only reference materials by name */
+	UPROPERTY()
+	TArray<FString> MaterialNames;
+
+	UPROPERTY()
+	bool bExportLods = true;
+};
+
+USTRUCT()
+struct FUnrealToUnityExporterFbxWorkerShard
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FUnrealToUnityExporterFbxWorkerMesh> Meshes;
+};
+
+USTRUCT()
+struct FUnrealToUnityExporterFbxWorkerResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	bool bIsExported = false;
+
+	UPROPERTY()
+	double ExportSeconds = 0.0;
+
+	UPROPERTY()
+	int64 BytesWritten = 0;
+};
+
+USTRUCT()
+struct FUnrealToUnityExporterFbxWorkerShardResult
+{
+	GENERATED_BODY()
+
+	/** Same order as the meshes of the shard */
+	UPROPERTY()
+	TArray<FUnrealToUnityExporterFbxWorkerResult> Results;
+};
+
+/**
+ * Exports FBX files in separate editor processes, the FBX SDK isn't thread safe so this is the only way to use more cores.
+ * Workers are launched on first use and kept alive for every batch of the export, each one picks up its numbered shard files
+ * from the working directory and answers with a result file, like shader compile workers do.
+ *
+ * A worker which fails, exits early or stops answering only loses its own shard, the caller exports every mesh without a result itself.
+ * Such a worker is terminated and left out of later batches.
+ */
+class FUnrealToUnityExporterFbxWorkers
+{
+public:
+	FUnrealToUnityExporterFbxWorkers(const FString& InWorkingDirectory, int32 InProcessCount);
+	~FUnrealToUnityExporterFbxWorkers();
+
+	/** OutResults matches Meshes */
+	void Export(TConstArrayView<FUnrealToUnityExporterFbxWorkerMesh> Meshes, TArray<FUnrealToUnityExporterFbxWorkerResult>& OutResults);
+
+	static FString GetShardPath(const FString& WorkingDirectory, int32 WorkerIndex, int32 ShardIndex);
+	static FString GetResultPath(const FString& WorkingDirectory, int32 WorkerIndex, int32 ShardIndex);
+	static FString GetShutdownPath(const FString& WorkingDirectory);
+
+private:
+	bool LaunchWorkers();
+	void ShutdownWorkers();
+	void TerminateWorker(int32 WorkerIndex);
+
+	/** Starting an editor only pays off with a few meshes to export */
+	static constexpr int32 MinMeshesPerWorker = 8;
+
+	/** Workers taking longer than this for their shard are considered stuck */
+	static constexpr double MinShardTimeoutSeconds = 120.0;
+	static constexpr double ShardTimeoutSecondsPerMesh = 30.0;
+
+	FString WorkingDirectory;
+	int32 ProcessCount;
+	/** Invalid for terminated workers, indices stay the worker indices of the shard files */
+	TArray<FProcHandle> ProcessHandles;
+	int32 NextShardIndex = 0;
+	bool bIsLaunchFailed = false;
+};
@@ -0,0 +1,137 @@
+﻿#include "UnrealToUnityExporterImportListener.h"
+
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "UnrealToUnityExporterImportNotifier.h"
+#include "Common/TcpListener.h"
+#include "Dom/JsonObject.h"
+#include "HAL/IConsoleManager.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace
+{
+	TUniquePtr<FUnrealToUnityExporterImportListener> TestListener;
+
+	FAutoConsoleCommand StartTestListenerCommand(
+		TEXT("UnrealToUnityExporter.StartTestListener"),
+		TEXT("Starts a stand-in for the Unity importer which logs and acknowledges every export notification. Optional argument: port"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([] (const TArray<FString>& Args)
+		{
+			const uint16 Port = Args.IsEmpty() ? FUnrealToUnityExporterImportNotifier::Port : static_cast<uint16>(FCString::Atoi(*Args[0]));
+
+			TestListener.Reset();
+			TestListener = MakeUnique<FUnrealToUnityExporterImportListener>(Port);
+
+			if (!TestListener->IsListening())
+			{
+				UE_LOG(LogTemp, Error, TEXT("Test listener couldn't listen on port %d"), Port);
+				TestListener.Reset();
+			}
+		}));
+
+	FAutoConsoleCommand StopTestListenerCommand(
+		TEXT("UnrealToUnityExporter.StopTestListener"),
+		TEXT("Stops the stand-in for the Unity importer"),
+		FConsoleCommandDelegate::CreateLambda([]
+		{
+			TestListener.Reset();
+		}));
+}
+
+FUnrealToUnityExporterImportListener::FUnrealToUnityExporterImportListener(uint16 Port)
+{
+	TcpListener = MakeUnique<FTcpListener>(FIPv4Endpoint(FIPv4Address(127, 0, 0, 1), Port));
+	TcpListener->OnConnectionAccepted().BindRaw(this, &FUnrealToUnityExporterImportListener::HandleConnectionAccepted);
+}
+
+FUnrealToUnityExporterImportListener::~FUnrealToUnityExporterImportListener()
+{
+	bIsStopping = true;
+	TcpListener.Reset();
+}
+
+bool FUnrealToUnityExporterImportListener::IsListening() const
+{
+	return TcpListener && TcpListener->IsActive();
+}
+
+bool FUnrealToUnityExporterImportListener::HandleConnectionAccepted(FSocket* Socket, const FIPv4Endpoint& Endpoint)
+{
+	UE_LOG(LogTemp, Display, TEXT("Test listener accepted %s"), *Endpoint.ToString());
+
+	// Served on the listener thread, the exporter only opens one connection at a time
+	while (!bIsStopping)
+	{
+		uint8 SizeBytes[4];
+		if (!ReceiveExactly(*Socket, SizeBytes, sizeof(SizeBytes)))
+		{
+			break;
+		}
+
+		const uint32 PayloadSize = SizeBytes[0] | (SizeBytes[1] << 8) | (SizeBytes[2] << 16) | (static_cast<uint32>(SizeBytes[3]) << 24);
+
+		TArray<uint8> Payload;
+		Payload.SetNumUninitialized(PayloadSize);
+		if (!ReceiveExactly(*Socket, Payload.GetData(), Payload.Num()))
+		{
+			break;
+		}
+
+		const FString JsonString(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Payload.GetData()), Payload.Num()));
+		UE_LOG(LogTemp, Display, TEXT("Test listener received: %s"), *JsonString);
+
+		TSharedPtr<FJsonObject> JsonObject;
+		uint32 Sequence = 0;
+
+		if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(JsonString), JsonObject) || !JsonObject.IsValid() || !JsonObject->TryGetNumberField(TEXT("sequence"), Sequence))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Test listener received an invalid frame"));
+			break;
+		}
+
+		uint8 Ack[4] = { static_cast<uint8>(Sequence), static_cast<uint8>(Sequence >> 8), static_cast<uint8>(Sequence >> 16), static_cast<uint8>(Sequence >> 24) };
+		int32 BytesSent = 0;
+		if (!Socket->Send(Ack, sizeof(Ack), BytesSent))
+		{
+			break;
+		}
+
+		if (JsonObject->GetStringField(TEXT("type")) == TEXT("end"))
+		{
+			break;
+		}
+	}
+
+	Socket->Close();
+	ISocketSubsystem::Get()->DestroySocket(Socket);
+
+	UE_LOG(LogTemp, Display, TEXT("Test listener closed %s"), *Endpoint.ToString());
+	return true;
+}
+
+bool FUnrealToUnityExporterImportListener::ReceiveExactly(FSocket& Socket, uint8* Data, int32 Size) const
+{
+	for (int32 ReceivedSize = 0; ReceivedSize < Size;)
+	{
+		if (bIsStopping)
+		{
+			return false;
+		}
+
+		if (!Socket.Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromSeconds(1.0)))
+		{
+			continue;
+		}
+
+		int32 BytesRead = 0;
+		if (!Socket.Recv(Data + ReceivedSize, Size - ReceivedSize, BytesRead) || BytesRead <= 0)
+		{
+			return false;
+		}
+
+		ReceivedSize += BytesRead;
+	}
+
+	return true;
+}
@@ -0,0 +1,32 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+class FSocket;
+class FTcpListener;
+struct FIPv4Endpoint;
+
+/**
+ * Local stand-in for the Unity importer, for testing the notification protocol without Unity.
+ * Logs and acknowledges every frame, see FUnrealToUnityExporterImportNotifier for the protocol.
+ *
+ * UnrealToUnityExporter.StartTestListener [Port]
+ * UnrealToUnityExporter.StopTestListener
+ */
+class FUnrealToUnityExporterImportListener
+{
+public:
+	explicit FUnrealToUnityExporterImportListener(uint16 Port);
+	~FUnrealToUnityExporterImportListener();
+
+	bool IsListening() const;
+
+private:
+	bool HandleConnectionAccepted(FSocket* Socket, const FIPv4Endpoint& Endpoint);
+	bool ReceiveExactly(FSocket& Socket, uint8* Data, int32 Size) const;
+
+	TUniquePtr<FTcpListener> TcpListener;
+	std::atomic<bool> bIsStopping = false;
+};
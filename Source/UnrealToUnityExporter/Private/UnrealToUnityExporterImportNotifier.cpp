@@ -0,0 +1,253 @@
+﻿#include "UnrealToUnityExporterImportNotifier.h"
+
+#include "JsonObjectConverter.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "Common/TcpSocketBuilder.h"
+#include "Dom/JsonObject.h"
+#include "Interfaces/IPv4/IPv4Endpoint.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/ScopedTimers.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+FUnrealToUnityExporterImportNotifier::FUnrealToUnityExporterImportNotifier()
+{
+}
+
+FUnrealToUnityExporterImportNotifier::~FUnrealToUnityExporterImportNotifier()
+{
+	Disconnect();
+}
+
+void FUnrealToUnityExporterImportNotifier::Begin(const FString& InExportDirectory)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_Notify);
+	FScopedDurationTimer Timer(BusySeconds);
+
+	ExportDirectory = InExportDirectory;
+	Connect();
+}
+
+void FUnrealToUnityExporterImportNotifier::Connect()
+{
+	NextSequence = 0;
+	AcknowledgedMessageCount = 0;
+	AckBuffer.Reset();
+
+	const FIPv4Endpoint Endpoint(FIPv4Address(127, 0, 0, 1), Port);
+
+	Socket = FTcpSocketBuilder(TEXT("UnrealToUnityMeshExporterNotifier")).AsBlocking();
+
+	if (!Socket || !Socket->Connect(Endpoint.ToInternetAddr().Get()))
+	{
+		UE_LOG(LogTemp, Display, TEXT("Unity importer isn't listening on port %d, it will be notified once the export ends"), Port);
+		Disconnect();
+		return;
+	}
+
+	bIsConnected = true;
+
+	const TSharedRef<FJsonObject> JsonObject = MakeShared<FJsonObject>();
+	JsonObject->SetStringField(TEXT("exportDirectory"), ExportDirectory);
+	SendMessage(TEXT("begin"), JsonObject);
+}
+
+void FUnrealToUnityExporterImportNotifier::NotifyMaterial(const FUnrealToUnityExporterMaterialDescriptor& MaterialDescriptor)
+{
+	bool bIsAlreadyNotified = false;
+	NotifiedMaterialPaths.Add(MaterialDescriptor.MaterialPath, &bIsAlreadyNotified);
+
+	if (!bIsConnected || bIsAlreadyNotified)
+	{
+		return;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_Notify);
+	FScopedDurationTimer Timer(BusySeconds);
+
+	const TSharedRef<FJsonObject> JsonObject = MakeShared<FJsonObject>();
+	JsonObject->SetObjectField(TEXT("material"), FJsonObjectConverter::UStructToJsonObject(MaterialDescriptor));
+	SendMessage(TEXT("material"), JsonObject);
+}
+
+void FUnrealToUnityExporterImportNotifier::NotifyMesh(const FUnrealToUnityExporterMeshDescriptor& MeshDescriptor)
+{
+	if (!bIsConnected)
+	{
+		return;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_Notify);
+	FScopedDurationTimer Timer(BusySeconds);
+
+	const TSharedRef<FJsonObject> JsonObject = MakeShared<FJsonObject>();
+	JsonObject->SetObjectField(TEXT("mesh"), FJsonObjectConverter::UStructToJsonObject(MeshDescriptor));
+	SendMessage(TEXT("mesh"), JsonObject);
+}
+
+bool FUnrealToUnityExporterImportNotifier::Finish(const FString& ImportDescriptorPath)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_Notify);
+	FScopedDurationTimer Timer(BusySeconds);
+
+	// Everything after the drop is only in the import descriptor, which the end frame points the importer to
+	if (bHasError)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Reconnecting to the Unity importer to announce the import descriptor"));
+		bHasError = false;
+		Connect();
+	}
+
+	if (bIsConnected)
+	{
+		const TSharedRef<FJsonObject> JsonObject = MakeShared<FJsonObject>();
+		JsonObject->SetStringField(TEXT("importDescriptorPath"), ImportDescriptorPath);
+		SendMessage(TEXT("end"), JsonObject);
+
+		ReceiveAcks(0);
+		Disconnect();
+
+		if (!bHasError)
+		{
+			return true;
+		}
+	}
+
+	// Nothing is listening on the framed port or the connection failed again, fall back to the single message of older importers
+	return SendLegacyMessage(ImportDescriptorPath);
+}
+
+double FUnrealToUnityExporterImportNotifier::GetBusySeconds() const
+{
+	return BusySeconds;
+}
+
+void FUnrealToUnityExporterImportNotifier::SendMessage(const FString& Type, const TSharedRef<FJsonObject>& JsonObject)
+{
+	JsonObject->SetNumberField(TEXT("sequence"), NextSequence++);
+	JsonObject->SetStringField(TEXT("type"), Type);
+
+	FString JsonString;
+	const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> JsonWriter = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&JsonString);
+	FJsonSerializer::Serialize(JsonObject, JsonWriter);
+
+	const FTCHARToUTF8 Utf8String(*JsonString);
+	const uint32 PayloadSize = Utf8String.Length();
+
+	TArray<uint8> Frame;
+	Frame.Reserve(sizeof(uint32) + PayloadSize);
+	Frame.Add(PayloadSize & 0xff);
+	Frame.Add((PayloadSize >> 8) & 0xff);
+	Frame.Add((PayloadSize >> 16) & 0xff);
+	Frame.Add((PayloadSize >> 24) & 0xff);
+	Frame.Append(reinterpret_cast<const uint8*>(Utf8String.Get()), PayloadSize);
+
+	for (int32 SentSize = 0; SentSize < Frame.Num();)
+	{
+		int32 BytesSent = 0;
+		if (!Socket->Send(Frame.GetData() + SentSize, Frame.Num() - SentSize, BytesSent) || BytesSent <= 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Unity importer connection lost while sending"));
+			bHasError = true;
+			Disconnect();
+			return;
+		}
+
+		SentSize += BytesSent;
+	}
+
+	// Unity gets ahead of the export by a bounded number of messages only
+	ReceiveAcks(MaxUnacknowledgedMessageCount);
+}
+
+bool FUnrealToUnityExporterImportNotifier::ReceiveAcks(int32 MaxUnacknowledgedMessages)
+{
+	while (bIsConnected && NextSequence - AcknowledgedMessageCount > static_cast<uint32>(MaxUnacknowledgedMessages))
+	{
+		if (!Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromSeconds(AckTimeoutSeconds)))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Unity importer didn't acknowledge message %u in time"), AcknowledgedMessageCount);
+			bHasError = true;
+			Disconnect();
+			return false;
+		}
+
+		uint8 Buffer[256];
+		int32 BytesRead = 0;
+		if (!Socket->Recv(Buffer, sizeof(Buffer), BytesRead) || BytesRead <= 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Unity importer connection lost while waiting for acknowledgements"));
+			bHasError = true;
+			Disconnect();
+			return false;
+		}
+
+		AckBuffer.Append(Buffer, BytesRead);
+
+		const int32 AckCount = AckBuffer.Num() / sizeof(uint32);
+		for (int32 AckIndex = 0; AckIndex < AckCount; AckIndex++)
+		{
+			const uint8* Ack = AckBuffer.GetData() + AckIndex * sizeof(uint32);
+			const uint32 Sequence = Ack[0] | (Ack[1] << 8) | (Ack[2] << 16) | (static_cast<uint32>(Ack[3]) << 24);
+
+			// Messages are acknowledged in order
+			AcknowledgedMessageCount = FMath::Max(AcknowledgedMessageCount, Sequence + 1);
+		}
+
+		AckBuffer.RemoveAt(0, AckCount * sizeof(uint32), false);
+	}
+
+	return bIsConnected;
+}
+
+void FUnrealToUnityExporterImportNotifier::Disconnect()
+{
+	bIsConnected = false;
+
+	if (Socket)
+	{
+		Socket->Shutdown(ESocketShutdownMode::ReadWrite);
+		Socket->Close();
+		ISocketSubsystem::Get()->DestroySocket(Socket);
+		Socket = nullptr;
+	}
+}
+
+bool FUnrealToUnityExporterImportNotifier::SendLegacyMessage(const FString& ImportDescriptorPath)
+{
+	const FIPv4Endpoint ClientEndpoint(FIPv4Address(127, 0, 0, 1), LegacyPort);
+	
+	FSocket* LegacySocket = FTcpSocketBuilder(TEXT("UnrealToUnityMeshExporterClient")).AsBlocking();
+
+	if (!LegacySocket->Connect(ClientEndpoint.ToInternetAddr().Get()))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Socket couldn't connect"));
+		ISocketSubsystem::Get()->DestroySocket(LegacySocket);
+		return false;
+	}
+	
+	FString Message = TEXT("unrealToUnityImporter?");
+
+	if (!ImportDescriptorPath.IsEmpty())
+	{
+		Message += TEXT("ImportDescriptorPath=");
+		Message += ImportDescriptorPath;
+	}
+
+	int32 Utf8Length = FTCHARToUTF8_Convert::ConvertedLength(*Message, Message.Len());
+	TArray<uint8> Buffer;
+	Buffer.SetNumUninitialized(Utf8Length);
+	FTCHARToUTF8_Convert::Convert((UTF8CHAR*)Buffer.GetData(), Buffer.Num(), *Message, Message.Len());
+	
+	int32 MessageBufferSize;
+	const bool bIsSent = LegacySocket->Send(Buffer.GetData(), Buffer.Num(), MessageBufferSize);
+
+	LegacySocket->Shutdown(ESocketShutdownMode::ReadWrite);
+	LegacySocket->Close();
+
+	ISocketSubsystem& SocketSubsystem = *(ISocketSubsystem::Get());
+	SocketSubsystem.DestroySocket(LegacySocket);
+
+	return bIsSent;
+}
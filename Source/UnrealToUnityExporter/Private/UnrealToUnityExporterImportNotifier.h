@@ -0,0 +1,68 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "UnrealToUnityExporter.h"
+
+class FJsonObject;
+class FSocket;
+
+/**
+ * Announces exported files to the Unity importer while the export is still running.
+ *
+ * Protocol, one TCP connection to 127.0.0.1:55721 per export:
+ *   Frame: uint32 little endian payload size followed by a UTF-8 JSON payload
+ *     {"sequence":0,"type":"begin","exportDirectory":"..."}
+ *     {"sequence":N,"type":"material","material":{MaterialDescriptor}}
+ *     {"sequence":N,"type":"mesh","mesh":{MeshDescriptor}}
+ *     {"sequence":N,"type":"end","importDescriptorPath":"..."}
+ *   Ack: the importer answers every frame with its uint32 little endian sequence number once it has queued it
+ *
+ * Materials are always announced before the meshes using them, and only after their files are on disk.
+ * If nothing listens on the framed port, the single unframed message is sent to the legacy port 55720 when the export ends.
+ * A connection lost during the export is opened again once at the end for the begin and end frames only, the import descriptor
+ * lists everything which wasn't announced. If that fails as well, the legacy message is sent.
+ * Notifying is best effort, failures are warnings and never fail the export.
+ * UnrealToUnityExporter.StartTestListener starts a local stand-in for the importer which logs and acknowledges every frame.
+ */
+class FUnrealToUnityExporterImportNotifier
+{
+public:
+	static constexpr uint16 Port = 55721;
+	static constexpr uint16 LegacyPort = 55720;
+
+	FUnrealToUnityExporterImportNotifier();
+	~FUnrealToUnityExporterImportNotifier();
+
+	void Begin(const FString& ExportDirectory);
+	/** Materials are announced once per material path */
+	void NotifyMaterial(const FUnrealToUnityExporterMaterialDescriptor& MaterialDescriptor);
+	void NotifyMesh(const FUnrealToUnityExporterMeshDescriptor& MeshDescriptor);
+
+	/** Returns false if the importer couldn't be notified in any way */
+	bool Finish(const FString& ImportDescriptorPath);
+
+	/** Time spent sending and waiting for acknowledgements */
+	double GetBusySeconds() const;
+
+private:
+	/** Opens the framed connection and sends the begin frame */
+	void Connect();
+	void SendMessage(const FString& Type, const TSharedRef<FJsonObject>& JsonObject);
+	bool ReceiveAcks(int32 MaxUnacknowledgedMessages);
+	void Disconnect();
+
+	static bool SendLegacyMessage(const FString& ImportDescriptorPath);
+
+	static constexpr int32 MaxUnacknowledgedMessageCount = 256;
+	static constexpr float AckTimeoutSeconds = 10.f;
+
+	FString ExportDirectory;
+	FSocket* Socket = nullptr;
+	bool bIsConnected = false;
+	bool bHasError = false;
+	double BusySeconds = 0.0;
+	uint32 NextSequence = 0;
+	uint32 AcknowledgedMessageCount = 0;
+	TArray<uint8> AckBuffer;
+	TSet<FString> NotifiedMaterialPaths;
+};
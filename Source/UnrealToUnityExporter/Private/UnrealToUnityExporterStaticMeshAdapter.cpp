@@ -2,15 +2,56 @@
 
 #include "MaterialBakingStructures.h"
 #include "MeshUtilities.h"
+#include "StaticMeshAttributes.h"
 #include "Developer/MeshMergeUtilities/Private/MeshMergeHelpers.h"
 
-FUnrealToUnityExporterStaticMeshAdapter::FUnrealToUnityExporterStaticMeshAdapter(UStaticMesh* InStaticMesh)
+TSharedRef<FMeshDescription> FUnrealToUnityExporterMeshDescriptionCache::GetMeshDescription(UStaticMesh* StaticMesh, int32 LODIndex)
+{
+	if (const TSharedRef<FMeshDescription>* MeshDescription = MeshDescriptions.Find({ StaticMesh, LODIndex }))
+	{
+		return *MeshDescription;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_RetrieveMesh);
+	TSharedRef<FMeshDescription> MeshDescription = MakeShared<FMeshDescription>();
+	FStaticMeshAttributes(*MeshDescription).Register();
+	FMeshMergeHelpers::RetrieveMesh(StaticMesh, LODIndex, *MeshDescription);
+	return MeshDescriptions.Add({ StaticMesh, LODIndex }, MeshDescription);
+}
+
+const TArray<FSectionInfo>& FUnrealToUnityExporterMeshDescriptionCache::GetSections(UStaticMesh* StaticMesh, int32 LODIndex)
+{
+	if (const TArray<FSectionInfo>* LODSections = Sections.Find({ StaticMesh, LODIndex }))
+	{
+		return *LODSections;
+	}
+
+	TArray<FSectionInfo>& LODSections = Sections.Add({ StaticMesh, LODIndex });
+	FMeshMergeHelpers::ExtractSections(StaticMesh, LODIndex, LODSections);
+	return LODSections;
+}
+
+FUnrealToUnityExporterStaticMeshAdapter::FUnrealToUnityExporterStaticMeshAdapter(UStaticMesh* InStaticMesh, FUnrealToUnityExporterMeshDescriptionCache* InMeshDescriptionCache)
 	: StaticMesh(InStaticMesh)
+	, MeshDescriptionCache(InMeshDescriptionCache)
 {
 	checkf(StaticMesh != nullptr, TEXT("Invalid static mesh in adapter"));
 	NumLODs = StaticMesh->GetNumLODs();
 }
 
+TSharedRef<FMeshDescription> FUnrealToUnityExporterStaticMeshAdapter::GetSharedMeshDescription(int32 LODIndex) const
+{
+	if (MeshDescriptionCache)
+	{
+		return MeshDescriptionCache->GetMeshDescription(StaticMesh, LODIndex);
+	}
+
+	TSharedRef<FMeshDescription> MeshDescription = MakeShared<FMeshDescription>();
+	FStaticMeshAttributes(*MeshDescription).Register();
+	RetrieveRawMeshData(LODIndex, *MeshDescription, true /*bPropogateMeshData*/);
+	return MeshDescription;
+}
+
 int32 FUnrealToUnityExporterStaticMeshAdapter::GetNumberOfLODs() const
 {
 	return NumLODs;
@@ -18,11 +59,23 @@ int32 FUnrealToUnityExporterStaticMeshAdapter::GetNumberOfLODs() const
 
 void FUnrealToUnityExporterStaticMeshAdapter::RetrieveRawMeshData(int32 LODIndex, FMeshDescription& InOutRawMesh, bool bPropogateMeshData) const
 {
+	if (MeshDescriptionCache)
+	{
+		InOutRawMesh = *MeshDescriptionCache->GetMeshDescription(StaticMesh, LODIndex);
+		return;
+	}
+
 	FMeshMergeHelpers::RetrieveMesh(StaticMesh, LODIndex, InOutRawMesh);
 }
 
 void FUnrealToUnityExporterStaticMeshAdapter::RetrieveMeshSections(int32 LODIndex, TArray<FSectionInfo>& InOutSectionInfo) const
 {
+	if (MeshDescriptionCache)
+	{
+		InOutSectionInfo.Append(MeshDescriptionCache->GetSections(StaticMesh, LODIndex));
+		return;
+	}
+
 	FMeshMergeHelpers::ExtractSections(StaticMesh, LODIndex, InOutSectionInfo);
 }
 
@@ -1,11 +1,28 @@
 ﻿#pragma once
 
 #include "IMaterialBakingAdapter.h"
+#include "MeshDescription.h"
+
+/** Mesh descriptions and sections of every (mesh, LOD) the bake asked for, built once and shared by all adapters using the cache */
+class FUnrealToUnityExporterMeshDescriptionCache
+{
+public:
+	TSharedRef<FMeshDescription> GetMeshDescription(UStaticMesh* StaticMesh, int32 LODIndex);
+	const TArray<FSectionInfo>& GetSections(UStaticMesh* StaticMesh, int32 LODIndex);
+
+private:
+	TMap<TPair<const UStaticMesh*, int32>, TSharedRef<FMeshDescription>> MeshDescriptions;
+	TMap<TPair<const UStaticMesh*, int32>, TArray<FSectionInfo>> Sections;
+};
 
 class FUnrealToUnityExporterStaticMeshAdapter : public IMaterialBakingAdapter
 {
 public:
-	FUnrealToUnityExporterStaticMeshAdapter(UStaticMesh* InStaticMesh);
+	/** Without a cache every retrieve call builds the mesh data again */
+	FUnrealToUnityExporterStaticMeshAdapter(UStaticMesh* InStaticMesh, FUnrealToUnityExporterMeshDescriptionCache* InMeshDescriptionCache = nullptr);
+
+	/** Avoids the copy RetrieveRawMeshData has to make, the description is shared with everyone else using the cache */
+	TSharedRef<FMeshDescription> GetSharedMeshDescription(int32 LODIndex) const;
 
 	/** Begin IMaterialBakingAdapter overrides */
 	virtual int32 GetNumberOfLODs() const override;
@@ -29,5 +46,6 @@ public:
 
 protected:
 	UStaticMesh* StaticMesh;
+	FUnrealToUnityExporterMeshDescriptionCache* MeshDescriptionCache;
 	int32 NumLODs;
 };
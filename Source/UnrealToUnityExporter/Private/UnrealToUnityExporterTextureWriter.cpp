@@ -0,0 +1,162 @@
+﻿#include "UnrealToUnityExporterTextureWriter.h"
+
+#include "IImageWrapperModule.h"
+#include "ImageUtils.h"
+#include "Hash/xxhash.h"
+#include "Misc/FileHelper.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+namespace
+{
+	uint32 GetConcurrency(int32 MaxConcurrency)
+	{
+		return MaxConcurrency > 0 ? MaxConcurrency : FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads(), 1);
+	}
+}
+
+FUnrealToUnityExporterTextureWriter::FUnrealToUnityExporterTextureWriter(const FString& InExportDirectory, int32 MaxConcurrency, int32 InMaxQueuedImages, int32 InPngQuality)
+	: ExportDirectory(InExportDirectory)
+	, ConcurrencyLimiter(GetConcurrency(MaxConcurrency))
+	, MaxQueuedImages(FMath::Max(InMaxQueuedImages, 1))
+	, PngQuality(InPngQuality)
+{
+	// Image wrappers are created from worker threads, module has to be loaded up front on the game thread
+	FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+}
+
+FUnrealToUnityExporterTextureWriter::~FUnrealToUnityExporterTextureWriter()
+{
+	Flush();
+}
+
+FString FUnrealToUnityExporterTextureWriter::Write(FImage&& Image, EUnrealToUnityExporterTextureFormat Format)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_HashTexture);
+
+	FString TextureName = GetImageHash(Image);
+	if (Format != EUnrealToUnityExporterTextureFormat::PNG)
+	{
+		TextureName += TEXT("_");
+		TextureName += FUnrealToUnityExporterBlockCompression::GetFormatName(Format);
+	}
+
+	const FString TexturePath = FString(TEXT("Textures/Shared")) / TextureName + TEXT(".") + FUnrealToUnityExporterBlockCompression::GetFileExtension(Format);
+	bool bIsAlreadyWritten;
+	WrittenTexturePaths.Add(TexturePath, &bIsAlreadyWritten);
+
+	if (bIsAlreadyWritten)
+	{
+		FScopeLock Lock(&FailedTexturePathsLock);
+		bIsAlreadyWritten = FailedTexturePaths.Remove(TexturePath) == 0;
+	}
+
+	// Same content always ends up in the same file, anything on disk from earlier exports is still valid
+	if (!bIsAlreadyWritten && !IFileManager::Get().FileExists(*(ExportDirectory / TexturePath)))
+	{
+		Enqueue(MoveTemp(Image), Format, TexturePath);
+	}
+	else
+	{
+		ReusedImageCount++;
+	}
+
+	return TexturePath;
+}
+
+FString FUnrealToUnityExporterTextureWriter::GetImageHash(const FImage& Image)
+{
+	FXxHash64Builder HashBuilder;
+	HashBuilder.Update(&Image.SizeX, sizeof(Image.SizeX));
+	HashBuilder.Update(&Image.SizeY, sizeof(Image.SizeY));
+	HashBuilder.Update(&Image.NumSlices, sizeof(Image.NumSlices));
+	HashBuilder.Update(&Image.Format, sizeof(Image.Format));
+	HashBuilder.Update(&Image.GammaSpace, sizeof(Image.GammaSpace));
+	HashBuilder.Update(Image.RawData.GetData(), Image.RawData.Num());
+
+	return FString::Printf(TEXT("%016llx"), HashBuilder.Finalize().Hash);
+}
+
+void FUnrealToUnityExporterTextureWriter::Enqueue(FImage&& Image, EUnrealToUnityExporterTextureFormat Format, const FString& TexturePath)
+{
+	while (QueuedImageCount.load() >= MaxQueuedImages)
+	{
+		QueueSpaceAvailableEvent->Wait();
+	}
+
+	++QueuedImageCount;
+
+	ConcurrencyLimiter.Push(TEXT("UnrealToUnityExporterTextureWrite"), [this, Image = MoveTemp(Image), Format, TexturePath, ExportPath = ExportDirectory / TexturePath] (uint32 /*ConcurrencySlot*/)
+	{
+		// Written next to the final file and moved into place, an interrupted export never leaves a truncated file behind
+		const FString TemporaryExportPath = FPaths::GetBaseFilename(ExportPath, false) + TEXT(".tmp.") + FPaths::GetExtension(ExportPath);
+
+		TArray64<uint8> EncodedImage;
+		bool bIsWritten;
+		{
+			TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_EncodeTexture);
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			if (Format == EUnrealToUnityExporterTextureFormat::PNG)
+			{
+				bIsWritten = FImageUtils::CompressImage(EncodedImage, *FPaths::GetExtension(ExportPath), Image, PngQuality);
+			}
+			else
+			{
+				EncodedImage = FUnrealToUnityExporterBlockCompression::CompressToDds(Image, Format);
+				bIsWritten = !EncodedImage.IsEmpty();
+			}
+			EncodeCycles += FPlatformTime::Cycles64() - StartCycles;
+		}
+
+		if (bIsWritten)
+		{
+			TRACE_CPUPROFILER_EVENT_SCOPE(UnrealToUnityExporter_WriteTexture);
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			bIsWritten = FFileHelper::SaveArrayToFile(EncodedImage, *TemporaryExportPath) && IFileManager::Get().Move(*ExportPath, *TemporaryExportPath);
+			WriteCycles += FPlatformTime::Cycles64() - StartCycles;
+		}
+
+		if (bIsWritten)
+		{
+			BytesWritten += EncodedImage.Num();
+			++WrittenImageCount;
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("Texture couldn't be written: %s"), *ExportPath);
+			++ErrorCount;
+
+			FScopeLock Lock(&FailedTexturePathsLock);
+			FailedTexturePaths.Add(TexturePath);
+		}
+
+		--QueuedImageCount;
+		QueueSpaceAvailableEvent->Trigger();
+	});
+}
+
+bool FUnrealToUnityExporterTextureWriter::Flush(FTimespan Timeout)
+{
+	return ConcurrencyLimiter.Wait(Timeout);
+}
+
+int32 FUnrealToUnityExporterTextureWriter::GetErrorCount() const
+{
+	return ErrorCount.load();
+}
+
+bool FUnrealToUnityExporterTextureWriter::IsWriteFailed(const FString& TexturePath) const
+{
+	FScopeLock Lock(&FailedTexturePathsLock);
+	return FailedTexturePaths.Contains(TexturePath);
+}
+
+FUnrealToUnityExporterTextureWriterStats FUnrealToUnityExporterTextureWriter::GetStats() const
+{
+	FUnrealToUnityExporterTextureWriterStats Stats;
+	Stats.EncodeSeconds = FPlatformTime::ToSeconds64(EncodeCycles.load());
+	Stats.WriteSeconds = FPlatformTime::ToSeconds64(WriteCycles.load());
+	Stats.BytesWritten = BytesWritten.load();
+	Stats.WrittenImageCount = WrittenImageCount.load();
+	Stats.ReusedImageCount = ReusedImageCount;
+	return Stats;
+}
@@ -0,0 +1,69 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "ImageCore.h"
+#include "UnrealToUnityExporterBlockCompression.h"
+#include "Tasks/TaskConcurrencyLimiter.h"
+
+struct FUnrealToUnityExporterTextureWriterStats
+{
+	/** Summed over all worker tasks */
+	double EncodeSeconds = 0.0;
+	double WriteSeconds = 0.0;
+	int64 BytesWritten = 0;
+	int32 WrittenImageCount = 0;
+	int32 ReusedImageCount = 0;
+};
+
+/**
+ * Encodes and writes exported images on task graph workers while the game thread keeps extracting mips.
+ * At most MaxConcurrency images are encoded at the same time and at most MaxQueuedImages are kept in memory,
+ * Write blocks the calling thread while the queue is full.
+ *
+ * Images are content addressed: every distinct image is written once into the shared texture folder, no matter
+ * how many materials reference it, and files already written by a previous export are kept as they are.
+ * An image whose write failed is written again when the same content comes up later.
+ * The same image written in different formats ends up in different files.
+ */
+class FUnrealToUnityExporterTextureWriter
+{
+public:
+	/** PngQuality is passed to the PNG encoder, 0 is its default zlib level and 2 - 9 pick a level */
+	FUnrealToUnityExporterTextureWriter(const FString& InExportDirectory, int32 MaxConcurrency, int32 InMaxQueuedImages, int32 InPngQuality = 0);
+	~FUnrealToUnityExporterTextureWriter();
+
+	/** Returns the path of the image relative to the export directory, block compressed formats are written as DDS */
+	FString Write(FImage&& Image, EUnrealToUnityExporterTextureFormat Format = EUnrealToUnityExporterTextureFormat::PNG);
+
+	/** Blocks until every queued image is on disk, returns false if some are still queued after Timeout */
+	bool Flush(FTimespan Timeout = FTimespan::MaxValue());
+
+	int32 GetErrorCount() const;
+
+	/** Path as returned by Write, only final for images which were flushed and not written again since */
+	bool IsWriteFailed(const FString& TexturePath) const;
+
+	/** Only complete after Flush */
+	FUnrealToUnityExporterTextureWriterStats GetStats() const;
+
+private:
+	static FString GetImageHash(const FImage& Image);
+	void Enqueue(FImage&& Image, EUnrealToUnityExporterTextureFormat Format, const FString& TexturePath);
+
+	FString ExportDirectory;
+	TSet<FString> WrittenTexturePaths;
+	/** Filled by the worker tasks, the next image with the same content writes them again */
+	TSet<FString> FailedTexturePaths;
+	mutable FCriticalSection FailedTexturePathsLock;
+	UE::Tasks::FTaskConcurrencyLimiter ConcurrencyLimiter;
+	FEventRef QueueSpaceAvailableEvent;
+	std::atomic<int32> QueuedImageCount = 0;
+	std::atomic<int32> ErrorCount = 0;
+	std::atomic<uint64> EncodeCycles = 0;
+	std::atomic<uint64> WriteCycles = 0;
+	std::atomic<int64> BytesWritten = 0;
+	std::atomic<int32> WrittenImageCount = 0;
+	int32 ReusedImageCount = 0;
+	int32 MaxQueuedImages;
+	int32 PngQuality;
+};
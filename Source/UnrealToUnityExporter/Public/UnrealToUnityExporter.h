@@ -7,6 +7,12 @@
 #include "UnrealToUnityExporter.generated.h"
 
 struct FExportSettings;
+class FUnrealToUnityExporterDescriptorWriter;
+class FUnrealToUnityExporterExportReport;
+struct FUnrealToUnityExporterExportReportAsset;
+class FUnrealToUnityExporterTextureWriter;
+class FUnrealToUnityExporterFbxWorkers;
+class FUnrealToUnityExporterExportCache;
 
 USTRUCT()
 struct FUnrealToUnityExporterTextureDescriptor
@@ -33,6 +39,10 @@ struct FUnrealToUnityExporterTextureDescriptor
 	
 	UPROPERTY()
 	FString TexturePath;
+
+	/** PNG, or the block compression of a DDS file which should be imported as it is */
+	UPROPERTY()
+	FString TextureFormat;
 };
 
 USTRUCT()
@@ -49,6 +59,16 @@ struct FUnrealToUnityExporterMaterialDescriptor
 	UPROPERTY()
 	TArray<FUnrealToUnityExporterTextureDescriptor> TextureDescriptors;
 
+	/**
+	 * Unity's HDRP/URP mask map, metallic (R), occlusion (G), detail mask (B) and smoothness (A). When set, Metallic and
+	 * Roughness aren't part of TextureDescriptors. Empty if the material doesn't use a packed mask map.
+	 */
+	UPROPERTY()
+	FString MaskMapPath;
+
+	UPROPERTY()
+	FString MaskMapFormat;
+
 	// TODO: EmissiveScale
 	// TODO: AO
 };
@@ -65,21 +85,6 @@ struct FUnrealToUnityExporterMeshDescriptor
 	bool bEnableReadWrite = false;
 };
 
-USTRUCT()
-struct FUnrealToUnityExporterImportDescriptor
-{
-	GENERATED_BODY()
-
-	UPROPERTY()
-	FString ExportDirectory;
-
-	UPROPERTY()
-	TArray<FUnrealToUnityExporterMaterialDescriptor> MaterialDescriptors;
-	
-	UPROPERTY()
-	TArray<FUnrealToUnityExporterMeshDescriptor> MeshDescriptors;
-};
-
 USTRUCT()
 struct FUnrealToUnityExporterMaterialData
 {
@@ -90,7 +95,19 @@ struct FUnrealToUnityExporterMaterialData
 	UPROPERTY()
 	TObjectPtr<UMaterialInterface> BakedMaterialInterface = nullptr;
 
+	/** Set instead of baking when the material only forwards textures and constants, which are exported from their sources */
+	UPROPERTY()
+	TObjectPtr<UMaterialInterface> PassThroughMaterialInterface = nullptr;
+
 	TEnumAsByte<EBlendMode> OriginalBlendMode = BLEND_Opaque;
+
+	/** Set when the material is merged into an equivalent one, which is baked and exported in its place */
+	FName CanonicalMaterialName;
+
+	/** Equal for materials rendering the same, empty for materials merged into another one or loaded from the journal */
+	FString CanonicalMaterialKey;
+
+	bool bIsExported = false;
 };
 
 class FUnrealToUnityExporterModule : public IModuleInterface
@@ -101,14 +118,14 @@ public:
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
 
+	/** Runs the whole export pipeline, returns false if anything failed to export */
+	static bool RunUnrealToUnityExporter(const FExportSettings& ExportSettings);
+
 private:
 	static void OpenExportSettingsWindow();
-	static void RunUnrealToUnityExporter(const FExportSettings& ExportSettings );
-	static void BakeOutStaticMeshes(const TArrayView<UStaticMesh*> StaticMeshes, TMap<FName, FUnrealToUnityExporterMaterialData>& OriginalPathsToMaterialData, const FExportSettings& ExportSettings);
-	static void ExportMeshes(const TArrayView<UStaticMesh*> StaticMeshes, const FString& ExportDirectory, FUnrealToUnityExporterImportDescriptor& ImportDescriptor, const FExportSettings& ExportSettings);
-	static void ExportMaterials(const TMap<FName, FUnrealToUnityExporterMaterialData>& OriginalPathsToMaterialData, const FString& ExportDirectory, FUnrealToUnityExporterImportDescriptor& ImportDescriptor);
-	static void ExportTextures(const UMaterialInterface& MaterialInterface, const FString& ExportDirectory, const FString& ExportFolder, FUnrealToUnityExporterMaterialDescriptor& MaterialDescriptor);
-	static void RevertChanges(const TArrayView<UStaticMesh*> StaticMeshes, const TArrayView<UMaterialInterface*> MaterialInterfaces);
-	static FString SaveImportDescriptor(const FUnrealToUnityExporterImportDescriptor& ImportDescriptor, const FString& ExportDirectory);
-	static void SendUnityImportMessage(const FString& ImportDescriptorSavePath);
+	static void BakeOutStaticMeshes(const TArrayView<UStaticMesh*> StaticMeshes, TMap<FName, FUnrealToUnityExporterMaterialData>& OriginalPathsToMaterialData, FUnrealToUnityExporterExportCache& ExportCache, const FExportSettings& ExportSettings, TArray<UStaticMesh*>& OutBakedStaticMeshes, TArray<bool>& OutAreMeshesBaked, FUnrealToUnityExporterExportReport& Report);
+	static bool ExportMeshes(const TArrayView<UStaticMesh*> StaticMeshes, const TArrayView<UStaticMesh*> BakedStaticMeshes, const FString& ExportDirectory, TArray<FUnrealToUnityExporterMeshDescriptor>& OutMeshDescriptors, TArray<bool>& OutAreMeshesExported, FUnrealToUnityExporterFbxWorkers& FbxWorkers, const FExportSettings& ExportSettings, FUnrealToUnityExporterExportReport& Report);
+	static void ExportMaterials(TMap<FName, FUnrealToUnityExporterMaterialData>& OriginalPathsToMaterialData, FUnrealToUnityExporterDescriptorWriter& DescriptorWriter, TMap<FName, FUnrealToUnityExporterMaterialDescriptor>& OriginalPathsToMaterialDescriptors, FUnrealToUnityExporterTextureWriter& TextureWriter, const FExportSettings& ExportSettings, FUnrealToUnityExporterExportReport& Report);
+	static void ExportTextures(const UMaterialInterface& MaterialInterface, FUnrealToUnityExporterMaterialDescriptor& MaterialDescriptor, FUnrealToUnityExporterTextureWriter& TextureWriter, const FExportSettings& ExportSettings, FUnrealToUnityExporterExportReport& Report, FUnrealToUnityExporterExportReportAsset& ReportAsset);
+	static void ExportPassThroughTextures(UMaterialInterface& MaterialInterface, FUnrealToUnityExporterMaterialDescriptor& MaterialDescriptor, FUnrealToUnityExporterTextureWriter& TextureWriter, const FExportSettings& ExportSettings, FUnrealToUnityExporterExportReport& Report, FUnrealToUnityExporterExportReportAsset& ReportAsset);
 };
@@ -35,14 +35,20 @@ public class UnrealToUnityExporter : ModuleRules
 			new string[]
 			{
 				"CoreUObject",
+				"DerivedDataCache",
 				"Engine",
 				"Slate",
 				"SlateCore",
 				"UnrealEd",
 				"ToolMenus", 
 				"MaterialBaking",
+				"MaterialUtilities",
 				"MeshMergeUtilities",
 				"RHI",
+				"MeshDescription",
+				"StaticMeshDescription",
+				"ImageCore",
+				"ImageWrapper",
 				"JSON",
 				"JsonUtilities",
 				"Networking",